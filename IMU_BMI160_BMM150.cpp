@@ -29,6 +29,7 @@
  */
 
 #include "IMU_BMI160_BMM150.h"
+#include "IMU_Sched.h"
 
 // === АДРЕСА И РЕГИСТРЫ BMI160 ===
 #define BMI160_ADDR_68 0x68
@@ -49,7 +50,9 @@
 #define BMI160_MAG_CONF     0x44
 #define BMI160_DATA_0       0x04
 #define BMI160_STATUS       0x1B
+#define BMI160_TEMPERATURE  0x20
 #define BMI160_BMM150_IF    0x7D
+#define BMI160_IF_CONF      0x6B
 #define BMI160_PMU_STATUS   0x03
 
 // Команды BMI160
@@ -93,9 +96,319 @@ static SensorConfig config = {
     .gyr_range = 0x00,  // ±2000°/s (значение по умолчанию)
 };
 static bool initialized = false;
+static int16_t temp_raw = IMU_TEMP_INVALID;
+// Буфер пакета данных: в него читают все функции чтения, массивы
+// вызывающего заполняются разбором из него (IMU_readView отдает его как есть)
+static IMU_SampleView sample_view = { {0}, 0, 0x05, 0x00, 0, 0 };
+// Сроки опроса датчиков для одной функции опроса
+struct PollSchedule {
+    IMU_Scheduler accgyr;  // Акселерометр и гироскоп
+    IMU_Scheduler mag;     // Магнитометр
+    float accgyr_hz;       // Частота, на которую настроен accgyr (0 — не настроен)
+    float mag_hz;
+};
+// У каждой функции опроса своя сетка сроков: вызов одной не сбрасывает
+// сроки другой (неиспользуемая удаляется компоновщиком с -fdata-sections)
+static PollSchedule freq_poll;    // IMU_readDataWithFrequency
+static PollSchedule sensor_poll;  // IMU_pollSensors, IMU_pollSensorsView
+static bool bmm150_pending = false;   // Forced Mode запущен, результат еще не прочитан
 float ACC_LSB = 8192.0f;  // Значение по умолчанию для ±4g (8192 LSB/g)
 float GYR_LSB = 16.384f;  // Значение по умолчанию для ±2000°/s (16.384 LSB/°/s)
 
+// === ШИНА ===
+
+/**
+ * @brief Проверяет ответ устройства на шине Wire (адрес + регистр)
+ */
+static bool wire_probe(uint8_t addr, uint8_t reg) {
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    return (Wire.endTransmission(true) == 0);
+}
+
+/**
+ * @brief Записывает len байт в устройство на шине Wire начиная с регистра reg
+ */
+static bool wire_write(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len) {
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    for (uint8_t i = 0; i < len; i++) {
+        Wire.write(data[i]);
+    }
+    return (Wire.endTransmission(true) == 0);
+}
+
+/**
+ * @brief Читает len байт из устройства на шине Wire начиная с регистра reg
+ * 
+ * Ожидает ответ устройства не дольше 10 мс
+ */
+static bool wire_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) {
+        return false;
+    }
+
+    unsigned long start = millis();
+    uint8_t received = 0;
+    while (millis() - start < 10 && received < len) {
+        received = Wire.requestFrom(addr, len);
+    }
+
+    if (received != len) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < len; i++) {
+        buf[i] = Wire.read();
+    }
+    return true;
+}
+
+static const IMU_Bus wire_bus = { wire_probe, wire_write, wire_read };
+static const IMU_Bus* bus = &wire_bus;
+static IMU_BusHook bus_hook = nullptr;
+static IMU_BusStats bus_stats = {};
+
+/**
+ * @brief Передает описание транзакции обработчику, если он установлен
+ */
+static void bus_notify(uint32_t t_us, uint8_t op, uint8_t addr, uint8_t reg,
+                       uint8_t len, bool ok, const uint8_t* data) {
+    IMU_BusEvent ev = { t_us, op, addr, reg, len, ok, data };
+    bus_hook(&ev);
+}
+
+// Счетчики считают байты на линии: адрес устройства, регистр, данные
+// и повторный адрес при чтении
+static bool bus_probe(uint8_t addr, uint8_t reg) {
+    bus_stats.transactions++;
+    bus_stats.bytes += 2;
+    if (!bus_hook) {
+        return bus->probe(addr, reg);
+    }
+    uint32_t t = micros();
+    bool ok = bus->probe(addr, reg);
+    bus_notify(t, IMU_BUS_PROBE, addr, reg, 0, ok, nullptr);
+    return ok;
+}
+
+static bool bus_write(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len) {
+    bus_stats.transactions++;
+    bus_stats.bytes += 2 + len;
+    if (!bus_hook) {
+        return bus->write(addr, reg, data, len);
+    }
+    uint32_t t = micros();
+    bool ok = bus->write(addr, reg, data, len);
+    bus_notify(t, IMU_BUS_WRITE, addr, reg, len, ok, data);
+    return ok;
+}
+
+static bool bus_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
+    bus_stats.transactions++;
+    bus_stats.bytes += 3 + len;
+    if (!bus_hook) {
+        return bus->read(addr, reg, buf, len);
+    }
+    uint32_t t = micros();
+    bool ok = bus->read(addr, reg, buf, len);
+    bus_notify(t, IMU_BUS_READ, addr, reg, len, ok, ok ? buf : nullptr);
+    return ok;
+}
+
+// === ТЕНЕВЫЕ КОПИИ РЕГИСТРОВ ===
+//
+// Для регистров конфигурации драйвер хранит копию последнего записанного
+// (или прочитанного) значения. Запись того же значения пропускается,
+// чтение конфигурации обслуживается из ОЗУ. Регистры с побочным эффектом
+// записи (команды, запуск обмена по вторичному интерфейсу, Forced Mode)
+// не кэшируются никогда.
+
+// Размер окна теневой копии (регистров)
+#define SHADOW_SIZE 16
+
+struct RegShadow {
+    uint8_t base;           // Первый регистр окна
+    uint16_t cacheable;     // Маска кэшируемых регистров окна
+    uint16_t valid;         // Маска регистров с известным значением
+    uint8_t val[SHADOW_SIZE];
+};
+
+// BMI160: 0x40-0x4F (ACC/GYR/MAG_CONF, FIFO, MAG_IF). Не кэшируются:
+// MAG_IF_2 (0x4D) и MAG_IF_3 (0x4E) — запись запускает обмен с BMM150
+static RegShadow bmi160_shadow = { 0x40, 0x9FFF, 0, {0} };
+
+// BMM150 (прямое подключение): 0x4B-0x52 (питание, прерывания, повторения).
+// Не кэшируется OPMODE (0x4C) — запись Forced Mode запускает измерение
+static RegShadow bmm150_shadow = { 0x4B, 0x00FD, 0, {0} };
+
+#if IMU_FEATURE_SHADOW
+static bool shadow_enabled = true;
+#else
+// Константа: все обращения к копиям отбрасываются при компиляции
+static const bool shadow_enabled = false;
+#endif
+static uint32_t shadow_scrub_interval = 0;
+static unsigned long shadow_last_scrub = 0;
+
+/**
+ * @brief Возвращает теневую копию устройства addr или nullptr
+ */
+static RegShadow* shadow_for(uint8_t addr) {
+    if (!shadow_enabled || addr == 0) {
+        return nullptr;
+    }
+    if (addr == bmi160_addr) {
+        return &bmi160_shadow;
+    }
+    if (addr == bmm150_addr && mag_mode == PRIMARY) {
+        return &bmm150_shadow;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Проверяет, что регистр reg попадает в окно и кэшируется
+ */
+static bool shadow_covers(const RegShadow* sh, uint8_t reg) {
+    uint8_t i = (uint8_t)(reg - sh->base);
+    return i < SHADOW_SIZE && (sh->cacheable & (1u << i));
+}
+
+/**
+ * @brief Обновляет теневую копию после успешного обмена
+ */
+static void shadow_store(RegShadow* sh, uint8_t reg, const uint8_t* data, uint8_t len) {
+    for (uint8_t k = 0; k < len; k++) {
+        uint8_t r = reg + k;
+        if (shadow_covers(sh, r)) {
+            uint8_t i = r - sh->base;
+            sh->val[i] = data[k];
+            sh->valid |= (1u << i);
+        }
+    }
+}
+
+/**
+ * @brief Забывает значения регистров reg..reg+len-1 (после неудачной записи)
+ */
+static void shadow_forget(RegShadow* sh, uint8_t reg, uint8_t len) {
+    for (uint8_t k = 0; k < len; k++) {
+        uint8_t i = (uint8_t)(reg + k - sh->base);
+        if (i < SHADOW_SIZE) {
+            sh->valid &= ~(1u << i);
+        }
+    }
+}
+
+/**
+ * @brief Проверяет, что все регистры reg..reg+len-1 известны, и копирует их значения
+ */
+static bool shadow_lookup(const RegShadow* sh, uint8_t reg, uint8_t* buf, uint8_t len) {
+    for (uint8_t k = 0; k < len; k++) {
+        uint8_t r = reg + k;
+        if (!shadow_covers(sh, r) || !(sh->valid & (1u << (r - sh->base)))) {
+            return false;
+        }
+        buf[k] = sh->val[r - sh->base];
+    }
+    return true;
+}
+
+/**
+ * @brief Запись регистров через теневую копию
+ * 
+ * Пропускает запись, если все регистры кэшируются и уже содержат эти значения.
+ * Команда Soft Reset сбрасывает теневую копию устройства.
+ */
+static bool reg_write(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len) {
+    RegShadow* sh = shadow_for(addr);
+    if (sh) {
+        uint8_t cur[SHADOW_SIZE];
+        if (len <= SHADOW_SIZE && shadow_lookup(sh, reg, cur, len) && memcmp(cur, data, len) == 0) {
+            bus_stats.writes_skipped++;
+            return true;
+        }
+    }
+
+    bool ok = bus_write(addr, reg, data, len);
+
+    if (sh) {
+        if (ok) {
+            shadow_store(sh, reg, data, len);
+        } else {
+            shadow_forget(sh, reg, len);
+        }
+        // Soft Reset: BMI160 — команда 0xB6 в CMD, BMM150 — биты 7 и 1 регистра питания
+        bool reset = (sh == &bmi160_shadow) ? (reg == BMI160_CMD && data[0] == BMI160_CMD_SOFTRESET)
+                                            : (reg == BMM150_POWER && (data[0] & 0x82) == 0x82);
+        if (reset) {
+            sh->valid = 0;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Чтение регистров через теневую копию
+ * 
+ * Если все регистры известны, данные берутся из ОЗУ без обращения к шине.
+ * Прочитанные с шины значения кэшируемых регистров запоминаются.
+ */
+static bool reg_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
+    RegShadow* sh = shadow_for(addr);
+    if (sh && shadow_lookup(sh, reg, buf, len)) {
+        bus_stats.reads_cached++;
+        return true;
+    }
+
+    bool ok = bus_read(addr, reg, buf, len);
+    if (sh && ok) {
+        shadow_store(sh, reg, buf, len);
+    }
+    return ok;
+}
+
+/**
+ * @brief Сверяет теневую копию с устройством и восстанавливает расхождения
+ * 
+ * Читает окно регистров одной транзакцией; регистры, значение которых
+ * отличается от копии (например, после сбоя питания датчика), перезаписываются.
+ */
+static void shadow_scrub(uint8_t addr) {
+    RegShadow* sh = shadow_for(addr);
+    if (!sh || !sh->valid) {
+        return;
+    }
+
+    uint8_t actual[SHADOW_SIZE];
+    if (!bus_read(addr, sh->base, actual, SHADOW_SIZE)) {
+        return;
+    }
+    for (uint8_t i = 0; i < SHADOW_SIZE; i++) {
+        if ((sh->valid & (1u << i)) && actual[i] != sh->val[i]) {
+            bus_write(addr, sh->base + i, &sh->val[i], 1);
+            bus_stats.scrub_repairs++;
+        }
+    }
+}
+
+/**
+ * @brief Выполняет периодическую сверку теневых копий, если она включена и подошел срок
+ */
+static void shadow_scrub_if_due() {
+    if (!shadow_enabled || !shadow_scrub_interval || millis() - shadow_last_scrub < shadow_scrub_interval) {
+        return;
+    }
+    shadow_last_scrub = millis();
+    shadow_scrub(bmi160_addr);
+    if (mag_mode == PRIMARY) {
+        shadow_scrub(bmm150_addr);
+    }
+}
+
 // === ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ ===
 
 /**
@@ -112,30 +425,12 @@ float GYR_LSB = 16.384f;  // Значение по умолчанию для ±2
  * @note Используется для обнаружения датчиков на шине I2C
  */
 static bool i2c_device_exists(uint8_t addr, uint8_t* chip_id, uint8_t reg) {
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    if (Wire.endTransmission(true) != 0) {
+    if (!bus_probe(addr, reg)) {
         return false;
     }
     
     if (chip_id) {
-        Wire.beginTransmission(addr);
-        Wire.write(reg);
-        if (Wire.endTransmission(false) != 0) {
-            return false;
-        }
-        
-        unsigned long start = millis();
-        uint8_t received = 0;
-        while (millis() - start < 5 && received == 0) {
-            received = Wire.requestFrom(addr, (uint8_t)1);
-        }
-        
-        if (received == 1) {
-            *chip_id = Wire.read();
-            return true;
-        }
-        return false;
+        return bus_read(addr, reg, chip_id, 1);
     }
     
     return true;
@@ -154,10 +449,7 @@ static bool i2c_device_exists(uint8_t addr, uint8_t* chip_id, uint8_t reg) {
  * @note Используется для настройки регистров датчиков
  */
 static bool i2c_safe_write(uint8_t addr, uint8_t reg, uint8_t val) {
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    Wire.write(val);
-    return (Wire.endTransmission(true) == 0);
+    return reg_write(addr, reg, &val, 1);
 }
 
 /**
@@ -175,30 +467,31 @@ static bool i2c_safe_write(uint8_t addr, uint8_t reg, uint8_t val) {
  * @note Используется для чтения данных с датчиков
  */
 static bool i2c_safe_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
-    if (!i2c_device_exists(addr, nullptr, 0x00)) {
-        return false;
+    RegShadow* sh = shadow_for(addr);
+    if (sh && shadow_lookup(sh, reg, buf, len)) {
+        bus_stats.reads_cached++;
+        return true;
     }
 
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    if (Wire.endTransmission(false) != 0) {
+    if (!i2c_device_exists(addr, nullptr, 0x00)) {
         return false;
     }
 
-    unsigned long start = millis();
-    uint8_t received = 0;
-    while (millis() - start < 10 && received < len) {
-        received = Wire.requestFrom(addr, len);
-    }
+    return reg_read(addr, reg, buf, len);
+}
 
-    if (received != len) {
-        return false;
-    }
+/**
+ * @brief Проверяет код диапазона акселерометра (0x03, 0x05, 0x08, 0x0C)
+ */
+static bool acc_range_valid(uint8_t range) {
+    return range == 0x03 || range == 0x05 || range == 0x08 || range == 0x0C;
+}
 
-    for (uint8_t i = 0; i < len; i++) {
-        buf[i] = Wire.read();
-    }
-    return true;
+/**
+ * @brief Проверяет код диапазона гироскопа (0x00-0x04)
+ */
+static bool gyr_range_valid(uint8_t range) {
+    return range <= 0x04;
 }
 
 /**
@@ -225,476 +518,613 @@ static void update_conversion_factors() {
     }
 }
 
-/**
- * @brief Инициализирует BMM150, подключенный напрямую к шине I2C
- * 
- * @param addr Адрес BMM150 (0x10-0x13)
- * @return true если инициализация прошла успешно, false в случае ошибки
- * 
- * Функция:
- * 1. Включает питание BMM150
- * 2. Проверяет Chip ID (должен быть 0x32)
- * 3. Настраивает BMM150 в нормальный режим работы
- * 
- * @note Требует, чтобы BMM150 был подключен напрямую к шине I2C
- */
-static bool init_bmm150_primary(uint8_t addr) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.print(F("  → Инициализация BMM150 на основном интерфейсе: 0x"));
-    Serial.println(addr, HEX);
-#endif
+#if IMU_FEATURE_AUTORANGE
+// === АВТОМАТИЧЕСКИЙ ВЫБОР ДИАПАЗОНА ===
+//
+// Переключение не останавливает поток: регистр диапазона записывается сразу
+// после чтения отсчета, а новый масштаб (ACC_LSB/GYR_LSB и метка диапазона)
+// вступает в силу на первом отсчете, измеренном после записи. Сразу после
+// записи регистры данных перечитываются: если отсчет не изменился, любой
+// следующий новый отсчет измерен уже в новом диапазоне. Если отсчет сменился
+// во время записи, его масштаб определяется по непрерывности сигнала.
+
+// Состояние автоматического выбора диапазона одного датчика
+struct AutoRange {
+    bool enabled;
+    bool pending;           // Регистр записан, новый масштаб еще не вступил в силу
+    bool last_is_new;       // Отсчет last измерен в новом диапазоне
+    bool quiet;             // Амплитуда ниже IMU_AUTORANGE_DOWN с момента quiet_us
+    uint8_t next_range;     // Записанный диапазон
+    int16_t last[3];        // Последний отсчет, прочитанный после записи
+    uint32_t quiet_us;
+};
 
-    // Power On
-    if (!i2c_safe_write(addr, BMM150_POWER, 0x01)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Ошибка включения питания"));
-#endif
-        return false;
-    }
-    delay(20);
+static AutoRange acc_auto = { false, false, false, false, 0, {0}, 0 };
+static AutoRange gyr_auto = { false, false, false, false, 0, {0}, 0 };
 
-    uint8_t chip_id = 0;
-    if (!i2c_safe_read(addr, BMM150_CHIP_ID, &chip_id, 1)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Ошибка чтения Chip ID"));
-#endif
-        return false;
-    }
+// Диапазоны от узкого к широкому; соседние отличаются вдвое
+static const uint8_t acc_ranges[] = { 0x03, 0x05, 0x08, 0x0C };
+static const uint8_t gyr_ranges[] = { 0x04, 0x03, 0x02, 0x01, 0x00 };
 
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.print(F("    Chip ID = 0x"));
-    Serial.println(chip_id, HEX);
-#endif
-    if (chip_id != 0x32) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Некорректный Chip ID"));
-#endif
-        return false;
+/**
+ * @brief Соседний диапазон: dir = +1 — шире, -1 — уже; 0xFF если его нет
+ */
+static uint8_t neighbour_range(const uint8_t* ranges, uint8_t count, uint8_t current, int8_t dir) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (ranges[i] == current) {
+            int8_t j = (int8_t)i + dir;
+            return (j >= 0 && j < (int8_t)count) ? ranges[j] : 0xFF;
+        }
     }
-    return true;
+    return 0xFF;
 }
 
 /**
- * @brief Инициализирует BMM150, подключенный через вторичный интерфейс BMI160
+ * @brief Выбирает масштаб отсчета, сменившегося во время записи регистра
  * 
- * @param phys_addr Физический адрес BMM150 (0x10-0x13)
- * @return true если инициализация прошла успешно, false в случае ошибки
+ * Соседние диапазоны отличаются вдвое, поэтому выбирается толкование,
+ * при котором отсчет ближе к предыдущему (сигнал непрерывен). Насыщенная
+ * ось предыдущего отсчета задает только нижнюю границу модуля.
  * 
- * Функция настраивает интерфейс BMI160 для взаимодействия с BMM150:
- * 1. Устанавливает адрес BMM150
- * 2. Включает питание BMM150 через интерфейс BMI160
- * 3. Настраивает BMM150 в нормальный режим работы
- * 4. Проверяет готовность данных магнитометра
- * 
- * @note Требует, чтобы BMM150 был подключен через BMI160
- * 
- * Важные моменты:
- * - Физический адрес BMM150 должен быть сдвинут вправо на 1 бит
- *   для получения 7-битного адреса вторичного интерфейса
- * - Для работы с BMM150 через вторичный интерфейс BMI160
- *   необходимо правильно настроить все регистры:
- *   * BMI160_MAG_IF_0 - адрес BMM150
- *   * BMI160_MAG_IF_1 - режим работы (запись/чтение)
- *   * BMI160_MAG_IF_2 - адрес данных BMM150 (0x42)
- *   * BMI160_MAG_IF_3 - регистр управления BMM150
- *   * BMI160_MAG_IF_4 - данные для записи
- * - Для нормальной работы BMM150 через вторичный интерфейс
- *   необходимо установить регистр MAG_CONF в 0x0B (10 Гц)
- */
-static bool init_bmm150_secondary(uint8_t phys_addr) {
-    // Рассчитываем 7-битный адрес для вторичного интерфейса
-    uint8_t sec_addr = phys_addr >> 1;
-    
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.print(F("  → Инициализация BMM150 через вторичный интерфейс (физический адрес: 0x"));
-    Serial.print(phys_addr, HEX);
-    Serial.println(F(")"));
-    
-    Serial.print(F("    Физический адрес 0x"));
-    Serial.print(phys_addr, HEX);
-    Serial.print(F(" → 7-битный адрес вторичного интерфейса: 0x"));
-    Serial.println(sec_addr, HEX);
-#endif
-
-    uint8_t chip_id = 0;
-    if (!i2c_device_exists(bmi160_addr, &chip_id, BMI160_CHIP_ID)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ BMI160 не отвечает"));
-#endif
-        return false;
+ * @param prev Отсчет перед записью (старый масштаб)
+ * @param v Отсчет после записи
+ * @param wider true — диапазон расширяется
+ * @return true если отсчет в новом масштабе
+ */
+static bool autorange_new_scale(const int16_t* prev, const int16_t* v, bool wider) {
+    int32_t d_old = 0, d_new = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        int32_t p = prev[i];
+        int32_t as_old = v[i];
+        int32_t as_new = wider ? as_old * 2 : as_old / 2; // В единицах старого масштаба
+        if (p >= 32767 || p <= -32768) {
+            if (as_old * p > 0 && labs(as_old) >= labs(p)) as_old = p;
+            if (as_new * p > 0 && labs(as_new) >= labs(p)) as_new = p;
+        }
+        d_old += labs(as_old - p);
+        d_new += labs(as_new - p);
     }
+    return d_new < d_old;
+}
 
-    // 1. Устанавливаем адрес BMM150
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_0, sec_addr)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить адрес BMM150"));
-#endif
-        return false;
-    }
-    delay(1);
+/**
+ * @brief Отслеживает амплитуду отсчета и при необходимости переключает диапазон
+ * 
+ * @param ar Состояние датчика
+ * @param v Только что прочитанный отсчет (x, y, z)
+ * @param gyro true — гироскоп, false — акселерометр
+ * @param read_us Время чтения отсчета
+ */
+static void autorange_step(AutoRange* ar, const int16_t* v, bool gyro, uint32_t read_us) {
+    uint8_t* range = gyro ? &config.gyr_range : &config.acc_range;
 
-    // 2. Переключаемся в режим записи
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80)) {
+    if (ar->pending) {
+        bool same = v[0] == ar->last[0] && v[1] == ar->last[1] && v[2] == ar->last[2];
+        if (same && !ar->last_is_new) {
+            return; // В регистрах еще отсчет в старом масштабе
+        }
+        *range = ar->next_range;
+        update_conversion_factors();
+        ar->pending = false;
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось переключиться в режим записи"));
+        Serial.print(gyro ? F("Диапазон гироскопа: 0x") : F("Диапазон акселерометра: 0x"));
+        Serial.println(*range, HEX);
 #endif
-        return false;
     }
-    delay(1);
 
-    // 3. Устанавливаем регистр управления (0x4B) для включения питания
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, 0x4B)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить регистр питания"));
-#endif
-        return false;
+    uint16_t peak = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        uint16_t a = v[i] < 0 ? (uint16_t)(-(int32_t)v[i]) : (uint16_t)v[i];
+        if (a > peak) {
+            peak = a;
+        }
     }
-    delay(1);
 
-    // 4. Устанавливаем значение питания (0x01)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_4, 0x01)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить значение питания"));
-#endif
-        return false;
+    const uint8_t* ranges = gyro ? gyr_ranges : acc_ranges;
+    uint8_t count = gyro ? sizeof(gyr_ranges) : sizeof(acc_ranges);
+    uint8_t next = 0xFF;
+    if (peak >= IMU_AUTORANGE_UP) {
+        next = neighbour_range(ranges, count, *range, +1);
+        ar->quiet = false;
+    } else if (peak < IMU_AUTORANGE_DOWN) {
+        if (!ar->quiet) {
+            ar->quiet = true;
+            ar->quiet_us = read_us;
+        } else if (read_us - ar->quiet_us >= IMU_AUTORANGE_HOLD_MS * 1000UL) {
+            next = neighbour_range(ranges, count, *range, -1);
+        }
+    } else {
+        ar->quiet = false;
     }
-    delay(1);
-
-    // 5. Применяем команду питания
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80 | (1 << 7))) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось применить команду питания"));
-#endif
-        return false;
+    if (next == 0xFF) {
+        return;
     }
-    delay(50);
 
-    // 6. Проверка статуса питания BMM150
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("    Проверка статуса питания BMM150..."));
-#endif
-    
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, 0x4B)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить регистр питания для чтения"));
-#endif
-        return false;
+    uint8_t data_reg = BMI160_DATA_0 + (gyro ? 8 : 14);
+    uint8_t raw[6];
+    if (!i2c_safe_write(bmi160_addr, gyro ? BMI160_GYR_RANGE : BMI160_ACC_RANGE, next)) {
+        return;
     }
-    delay(1);
-
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x00)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось настроить интерфейс для чтения"));
-#endif
-        return false;
+    ar->pending = true;
+    ar->next_range = next;
+    ar->quiet = false;
+    ar->last_is_new = false;
+    ar->last[0] = v[0];
+    ar->last[1] = v[1];
+    ar->last[2] = v[2];
+
+    // Контрольное чтение после записи: сменился ли отсчет, пока шла запись
+    if (i2c_safe_read(bmi160_addr, data_reg, raw, 6)) {
+        int16_t after[3];
+        for (uint8_t i = 0; i < 3; i++) {
+            after[i] = (int16_t)((raw[2 * i + 1] << 8) | raw[2 * i]);
+        }
+        if (after[0] != v[0] || after[1] != v[1] || after[2] != v[2]) {
+            ar->last_is_new = autorange_new_scale(v, after, next == neighbour_range(ranges, count, *range, +1));
+            ar->last[0] = after[0];
+            ar->last[1] = after[1];
+            ar->last[2] = after[2];
+        }
     }
-    delay(1);
+}
+#endif // IMU_FEATURE_AUTORANGE
+
+// === ДВИЖОК ПОСЛЕДОВАТЕЛЬНОСТЕЙ ИНИЦИАЛИЗАЦИИ ===
+//
+// Инициализация датчиков описывается константными таблицами шагов во flash
+// и выполняется интерпретатором run_init_sequence(). Подряд идущие записи
+// в соседние регистры интерпретатор объединяет в одну транзакцию.
+
+// Типы шагов
+enum InitOp : uint8_t {
+    STEP_WRITE,     // Запись val в reg
+    STEP_WRITE_ARG, // Запись args[val] в reg (значение известно только во время выполнения)
+    STEP_DELAY,     // Пауза time мс
+    STEP_POLL,      // Ожидание (reg & mask) == val не дольше time мс
+    STEP_VERIFY,    // Проверка (reg & mask) == val
+    STEP_END
+};
 
-    uint8_t power_status = 0;
-    if (!i2c_safe_read(bmi160_addr, BMI160_MAG_IF_4, &power_status, 1)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось прочитать статус питания"));
-#endif
-        return false;
-    }
+// Флаги шага записи (поле mask)
+#define STEP_VERIFIABLE 0x01 // Регистр конфигурации: при IMU_setInitVerify(true) проверяется чтением
 
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.print(F("    Статус питания BMM150: 0x"));
-    Serial.println(power_status, HEX);
-#endif
+// Максимальная длина объединенной записи (байт)
+#define INIT_MAX_BURST 8
 
-    if (power_status != 0x01) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Питание BMM150 не включено (ожидаем 0x01)"));
-#endif
-        return false;
-    }
+struct InitStep {
+    uint8_t op;
+    uint8_t reg;
+    uint8_t val;
+    uint8_t mask;
+    uint8_t time;
+};
 
-    // 7. Установка нормального режима работы BMM150
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("    Установка нормального режима работы BMM150..."));
-#endif
+static bool init_verify = false;
 
-    // Устанавливаем регистр режима (0x4C)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, 0x4C)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить регистр режима"));
-#endif
-        return false;
-    }
-    delay(1);
+/**
+ * @brief Выполняет таблицу шагов инициализации для устройства addr
+ * 
+ * @param addr Адрес устройства на шине
+ * @param steps Таблица шагов во flash (PROGMEM), завершается STEP_END
+ * @param args Значения для шагов STEP_WRITE_ARG (может быть nullptr)
+ * @return true если все шаги выполнены успешно
+ * 
+ * Записи в последовательные регистры (reg, reg + 1, ...) без промежуточных
+ * пауз объединяются в одну транзакцию длиной до INIT_MAX_BURST байт.
+ */
+static bool run_init_sequence(uint8_t addr, const InitStep* steps, const uint8_t* args) {
+    InitStep step;
+    uint8_t i = 0;
+    memcpy_P(&step, &steps[i], sizeof(step));
+
+    while (step.op != STEP_END) {
+        switch (step.op) {
+            case STEP_WRITE:
+            case STEP_WRITE_ARG: {
+                uint8_t burst[INIT_MAX_BURST];
+                uint8_t reg = step.reg;
+                uint8_t len = 0;
+                bool verifiable = true;
+
+                // Собираем подряд идущие записи в соседние регистры
+                while ((step.op == STEP_WRITE || step.op == STEP_WRITE_ARG) &&
+                       step.reg == (uint8_t)(reg + len) && len < INIT_MAX_BURST) {
+                    burst[len++] = (step.op == STEP_WRITE_ARG) ? args[step.val] : step.val;
+                    verifiable = verifiable && (step.mask & STEP_VERIFIABLE);
+                    memcpy_P(&step, &steps[++i], sizeof(step));
+                }
 
-    // Значение 0x06 соответствует нормальному режиму работы
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_4, 0x06)) {
+                if (!reg_write(addr, reg, burst, len)) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить нормальный режим"));
+                    Serial.print(F("    ❌ Ошибка записи в регистр 0x"));
+                    Serial.println(reg, HEX);
 #endif
-        return false;
-    }
-    delay(1);
+                    return false;
+                }
 
-    // Применяем команду
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80 | (1 << 7))) {
+                if (init_verify && verifiable) {
+                    uint8_t check[INIT_MAX_BURST];
+                    if (!bus_read(addr, reg, check, len) || memcmp(check, burst, len) != 0) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось применить команду режима"));
+                        Serial.print(F("    ❌ Проверка записи не прошла, регистр 0x"));
+                        Serial.println(reg, HEX);
 #endif
-        return false;
-    }
-    delay(50);
+                        return false;
+                    }
+                }
+                continue; // step уже указывает на следующий шаг
+            }
 
-    // 8. Настройка MAG_CONF для установки ODR (10 Гц)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_CONF, 0x0B)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось настроить MAG_CONF"));
-#endif
-        return false;
-    }
-    delay(1);
+            case STEP_DELAY:
+                delay(step.time);
+                break;
 
-    // 9. Установка адреса данных BMM150 (0x42)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_2, 0x42)) {
+            case STEP_POLL: {
+                unsigned long start = millis();
+                uint8_t value = 0;
+                for (;;) {
+                    if (bus_read(addr, step.reg, &value, 1) && (value & step.mask) == step.val) {
+                        break;
+                    }
+                    if (millis() - start >= step.time) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось установить регистр данных"));
+                        Serial.print(F("    ❌ Таймаут ожидания регистра 0x"));
+                        Serial.println(step.reg, HEX);
 #endif
-        return false;
-    }
-    delay(1);
+                        return false;
+                    }
+                    delay(1);
+                }
+                break;
+            }
 
-    // 10. Настройка длины пакета данных (8 байт: X, Y, Z, RHALL)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x03)) {
+            case STEP_VERIFY: {
+                uint8_t value = 0;
+                if (!reg_read(addr, step.reg, &value, 1) || (value & step.mask) != step.val) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось настроить длину пакета данных"));
+                    Serial.print(F("    ❌ Регистр 0x"));
+                    Serial.print(step.reg, HEX);
+                    Serial.print(F(" = 0x"));
+                    Serial.println(value, HEX);
 #endif
-        return false;
+                    return false;
+                }
+                break;
+            }
+        }
+        memcpy_P(&step, &steps[++i], sizeof(step));
     }
-    delay(1);
+    return true;
+}
 
-    // 11. Включаем магнитометр
-    if (!i2c_safe_write(bmi160_addr, BMI160_CMD, BMI160_CMD_MAG_NORMAL)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("    ❌ Не удалось включить магнитометр"));
-#endif
-        return false;
-    }
-    delay(100);
+// Сокращения для таблиц
+#define W(reg, val)         { STEP_WRITE, reg, val, 0, 0 }
+#define W_CFG(reg, val)     { STEP_WRITE, reg, val, STEP_VERIFIABLE, 0 }
+#define W_ARG(reg, idx)     { STEP_WRITE_ARG, reg, idx, STEP_VERIFIABLE, 0 }
+#define WAIT(ms)            { STEP_DELAY, 0, 0, 0, ms }
+#define POLL(reg, mask, val, timeout) { STEP_POLL, reg, val, mask, timeout }
+#define VERIFY(reg, mask, val) { STEP_VERIFY, reg, val, mask, 0 }
+#define END                 { STEP_END, 0, 0, 0, 0 }
+
+/**
+ * @brief Инициализация BMI160
+ * 
+ * args: ACC_CONF, ACC_RANGE, GYR_CONF, GYR_RANGE (регистры 0x40-0x43, одна транзакция)
+ * 
+ * Конфигурация записывается после Soft Reset: сброс возвращает регистры
+ * к значениям по умолчанию. Вместо фиксированных пауз после включения
+ * акселерометра и гироскопа опрашивается PMU_STATUS.
+ * 
+ * Пока акселерометр и гироскоп в suspend, BMI160 не принимает пакетную
+ * запись (и требует 450 мкс между одиночными), поэтому конфигурация
+ * записывается одной транзакцией только после перехода обоих в normal.
+ */
+static const InitStep bmi160_init_steps[] PROGMEM = {
+    W(BMI160_CMD, BMI160_CMD_SOFTRESET),
+    WAIT(1),                                   // Перезапуск после Soft Reset
+    W(BMI160_CMD, BMI160_CMD_ACC_NORMAL),
+    POLL(BMI160_PMU_STATUS, 0x30, 0x10, 10),  // acc_pmu_status = normal (≤ 3.8 мс)
+    W(BMI160_CMD, BMI160_CMD_GYR_NORMAL),
+    POLL(BMI160_PMU_STATUS, 0x0C, 0x04, 100), // gyr_pmu_status = normal (≤ 80 мс)
+    W_ARG(BMI160_ACC_CONF, 0),
+    W_ARG(BMI160_ACC_RANGE, 1),
+    W_ARG(BMI160_GYR_CONF, 2),
+    W_ARG(BMI160_GYR_RANGE, 3),
+    END
+};
+
+/**
+ * @brief Инициализация BMM150, подключенного напрямую к шине I2C
+ */
+static const InitStep bmm150_primary_steps[] PROGMEM = {
+    W(BMM150_POWER, 0x01),
+    WAIT(3),                                   // Переход suspend → sleep (3 мс)
+    VERIFY(BMM150_CHIP_ID, 0xFF, 0x32),
+    END
+};
+
+#if IMU_FEATURE_SECONDARY
+/**
+ * @brief Включение вторичного интерфейса BMI160 для BMM150 (ручной режим)
+ * 
+ * args: 7-битный адрес BMM150 на вторичной шине, сдвинутый на 1 бит влево
+ * (MAG_IF_0 хранит адрес в битах 7:1)
+ * 
+ * Вторичный интерфейс включается битом 5 IF_CONF (if_mode: магнитометр)
+ * и питается вместе с магнитометром BMI160, поэтому mag_pmu включается
+ * до первого обращения к BMM150.
+ */
+static const InitStep bmm150_aux_enable_steps[] PROGMEM = {
+    W(BMI160_BMM150_IF, 0x01),
+    W_CFG(BMI160_IF_CONF, 0x20),
+    W(BMI160_CMD, BMI160_CMD_MAG_NORMAL),
+    POLL(BMI160_PMU_STATUS, 0x03, 0x01, 10),  // mag_pmu_status = normal
+    // Адрес BMM150 и ручной режим (MAG_IF_0, MAG_IF_1 — одна транзакция)
+    W_ARG(BMI160_MAG_IF_0, 0),
+    W(BMI160_MAG_IF_1, 0x80),
+    END
+};
 
-    // 12. Проверка готовности данных
-    for (int i = 0; i < 200; i++) {
+/**
+ * @brief Перевод вторичного интерфейса в режим данных
+ * 
+ * В режиме данных BMI160 на каждом такте MAG_CONF сам записывает MAG_IF_4
+ * в регистр MAG_IF_3 BMM150 (Forced Mode, заданный последней ручной записью)
+ * и читает пакет X, Y, Z, RHALL с адреса MAG_IF_2 в DATA_0..DATA_7.
+ * 
+ * Запись MAG_IF_2 в ручном режиме запускает чтение, поэтому режим данных
+ * включается только после его окончания (mag_man_op = 0).
+ */
+static const InitStep bmm150_aux_data_steps[] PROGMEM = {
+    // ODR 100 Гц (MAX_MAG_FREQUENCY), адрес данных 0x42, пакет 8 байт
+    W_CFG(BMI160_MAG_CONF, 0x08),
+    W_CFG(BMI160_MAG_IF_2, BMM150_DATA_X),
+    POLL(BMI160_STATUS, 0x04, 0x00, 10),      // mag_man_op = 0
+    W_CFG(BMI160_MAG_IF_1, 0x03),
+    END
+};
+#endif // IMU_FEATURE_SECONDARY
+
+#undef W
+#undef W_CFG
+#undef W_ARG
+#undef WAIT
+#undef POLL
+#undef VERIFY
+#undef END
+
+#if IMU_FEATURE_SECONDARY
+// === ВСПОМОГАТЕЛЬНАЯ ШИНА BMI160 (MAG_IF) ===
+//
+// Регистры BMM150 за BMI160 доступны в ручном режиме интерфейса:
+// - чтение: запись адреса в MAG_IF_2 запускает пакет из 1, 2, 6 или 8 байт
+//   (длина — биты 1:0 MAG_IF_1), данные появляются в DATA_0..DATA_7
+// - запись: байт из MAG_IF_4 уходит в регистр BMM150 при записи адреса в MAG_IF_3,
+//   поэтому MAG_IF_4 записывается первым
+// Окончание обмена определяется по флагу mag_man_op (STATUS, бит 2), без пауз.
+
+// Длина пакета по коду битов 1:0 MAG_IF_1
+static const uint8_t aux_burst_len[4] = { 1, 2, 6, 8 };
+
+/**
+ * @brief Ждет окончания ручной операции вторичного интерфейса (mag_man_op = 0)
+ */
+static bool aux_wait_idle() {
+    uint32_t start = micros();
+    for (;;) {
         uint8_t status = 0;
-        if (i2c_safe_read(bmi160_addr, BMI160_STATUS, &status, 1) && (status & (1 << 5))) {
-            uint8_t data[8] = {0};
-            if (i2c_safe_read(bmi160_addr, BMI160_DATA_0, data, 8)) {
-                bool all_zero = true;
-                for (int j = 0; j < 8; j++) {
-                    if (data[j] != 0) {
-                        all_zero = false;
-                        break;
-                    }
-                }
-                
-                if (all_zero) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-                    Serial.println(F("    ⚠️ Данные все нулевые - проверьте подключение"));
-#endif
-                } else {
+        if (!bus_read(bmi160_addr, BMI160_STATUS, &status, 1)) {
+            return false;
+        }
+        if (!(status & 0x04)) {
+            return true;
+        }
+        if (micros() - start >= IMU_AUX_TIMEOUT_US) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-                    Serial.println(F("    ✅ Данные не нулевые. Синхронизация работает!"));
+            Serial.println(F("    ❌ Таймаут mag_man_op"));
 #endif
-                    return true;
-                }
-            }
+            return false;
         }
-        delay(1);
     }
+}
 
-    // 13. Если данные не готовы, пытаемся перезапустить магнитометр
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("    ⚠️ Таймаут ожидания drdy_mag. Попытка чтения данных..."));
-#endif
-    uint8_t data[8] = {0};
-    if (i2c_safe_read(bmi160_addr, BMI160_DATA_0, data, 8)) {
-        bool all_zero = true;
-        for (int j = 0; j < 8; j++) {
-            if (data[j] != 0) {
-                all_zero = false;
-                break;
-            }
+/**
+ * @brief Читает len байт регистров BMM150 начиная с reg (интерфейс в ручном режиме)
+ * 
+ * Блок разбивается на наибольшие допустимые пакеты (8, 6, 2, 1 байт).
+ * Каждый пакет — три транзакции: MAG_IF_1 + MAG_IF_2 одной записью,
+ * проверка mag_man_op и чтение DATA_0.
+ */
+static bool aux_read(uint8_t reg, uint8_t* buf, uint8_t len) {
+    while (len) {
+        uint8_t code = 3;
+        while (aux_burst_len[code] > len) {
+            code--;
         }
-        
-        if (all_zero) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("    ❌ Данные все нулевые - проверьте подключение"));
-#endif
+        uint8_t chunk = aux_burst_len[code];
+        const uint8_t cmd[2] = { (uint8_t)(0x80 | code), reg };
+        if (!reg_write(bmi160_addr, BMI160_MAG_IF_1, cmd, 2) || !aux_wait_idle() ||
+            !bus_read(bmi160_addr, BMI160_DATA_0, buf, chunk)) {
             return false;
-        } else {
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("    ✅ Данные не нулевые. Синхронизация работает!"));
-#endif
-            return true;
         }
+        reg += chunk;
+        buf += chunk;
+        len -= chunk;
     }
+    return true;
+}
 
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("    ❌ Таймаут ожидания drdy_mag или некорректный Chip ID"));
-#endif
-    return false;
+/**
+ * @brief Записывает байт в регистр BMM150 (интерфейс в ручном режиме)
+ */
+static bool aux_write(uint8_t reg, uint8_t val) {
+    return i2c_safe_write(bmi160_addr, BMI160_MAG_IF_4, val) &&
+           i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, reg) &&
+           aux_wait_idle();
+}
+
+/**
+ * @brief Переводит вторичный интерфейс в ручной режим (после IMU_begin)
+ */
+static bool aux_manual_begin() {
+    return mag_mode == SECONDARY && i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80);
+}
+
+/**
+ * @brief Возвращает вторичный интерфейс в режим данных
+ * 
+ * Если в ручном режиме была запись, MAG_IF_3/MAG_IF_4 снова настраиваются
+ * на запуск Forced Mode, который BMI160 выполняет на каждом такте.
+ */
+static bool aux_manual_end(bool wrote) {
+    if (wrote && !aux_write(BMM150_OPMODE, BMM150_FORCED_MODE)) {
+        return false;
+    }
+    return run_init_sequence(bmi160_addr, bmm150_aux_data_steps, nullptr);
 }
+#endif // IMU_FEATURE_SECONDARY
 
 /**
- * @brief Отправляет команду Forced Mode для BMM150 через вторичный интерфейс
+ * @brief Инициализирует BMM150, подключенный напрямую к шине I2C
  * 
- * @param addr Адрес BMM150
- * @return true если команда успешно отправлена, false в случае ошибки
+ * @param addr Адрес BMM150 (0x10-0x13)
+ * @return true если инициализация прошла успешно, false в случае ошибки
  * 
  * Функция:
- * 1. Активирует BMM150 интерфейс
- * 2. Устанавливает адрес BMM150
- * 3. Переключается в режим записи
- * 4. Устанавливает регистр OPMODE
- * 5. Устанавливает значение Forced Mode (0x02)
- * 6. Применяет команду
- * 7. Дает время на измерение и синхронизацию через вторичный интерфейс
- * 8. Проверяет, что данные готовы
- * 
- * Важные моменты:
- * - Для BMM150 в режиме Forced Mode требуется 1-2 мс на измерение
- * - После отправки команды необходимо подождать, прежде чем читать данные
- * - Если данные не готовы, выполняется попытка перезапуска магнитометра
- * 
- * @note Время ожидания установлено в 2 мс (согласно документации BMM150)
- */
-static bool send_forced_mode_secondary(uint8_t addr) {
+ * 1. Включает питание BMM150
+ * 2. Проверяет Chip ID (должен быть 0x32)
+ * 
+ * @note Требует, чтобы BMM150 был подключен напрямую к шине I2C
+ */
+static bool init_bmm150_primary(uint8_t addr) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("  → Отправка Forced Mode через вторичный интерфейс..."));
+    Serial.print(F("  → Инициализация BMM150 на основном интерфейсе: 0x"));
+    Serial.println(addr, HEX);
 #endif
 
-    // 1. Активируем BMM150 интерфейс
-    if (!i2c_safe_write(bmi160_addr, BMI160_BMM150_IF, 0x01)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось активировать BMM150 интерфейс"));
-#endif
-        return false;
-    }
-    delay(1);
+    return run_init_sequence(addr, bmm150_primary_steps, nullptr);
+}
 
-    // 2. Устанавливаем адрес BMM150
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_0, addr)) {
+#if IMU_FEATURE_SECONDARY
+/**
+ * @brief Инициализирует BMM150, подключенный через вторичный интерфейс BMI160
+ * 
+ * @param addr 7-битный адрес BMM150 на вторичной шине (0x10-0x13)
+ * @return true если инициализация прошла успешно, false в случае ошибки
+ * 
+ * Функция:
+ * 1. Включает интерфейс и переводит его в ручной режим (bmm150_aux_enable_steps)
+ * 2. Включает питание BMM150 и ждет Chip ID 0x32 (переход suspend → sleep, до 3 мс)
+ * 3. Записывает Forced Mode: MAG_IF_3/MAG_IF_4 остаются настроены на его запуск
+ * 4. Переводит интерфейс в режим данных (bmm150_aux_data_steps)
+ * 
+ * Все обращения к BMM150 — через aux_read()/aux_write() с ожиданием
+ * флага mag_man_op вместо фиксированных пауз.
+ */
+static bool init_bmm150_secondary(uint8_t addr) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось установить адрес BMM150"));
+    Serial.print(F("  → Инициализация BMM150 через вторичный интерфейс: 0x"));
+    Serial.println(addr, HEX);
 #endif
-        return false;
-    }
-    delay(1);
 
-    // 3. Переключаемся в режим записи
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80)) {
+    uint8_t chip_id = 0;
+    if (!i2c_device_exists(bmi160_addr, &chip_id, BMI160_CHIP_ID)) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось переключиться в режим записи"));
+        Serial.println(F("    ❌ BMI160 не отвечает"));
 #endif
         return false;
     }
-    delay(1);
 
-    // 4. Устанавливаем регистр OPMODE
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, BMM150_OPMODE)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось установить регистр OPMODE"));
-#endif
+    const uint8_t if_addr = (uint8_t)(addr << 1);
+    if (!run_init_sequence(bmi160_addr, bmm150_aux_enable_steps, &if_addr) ||
+        !aux_write(BMM150_POWER, 0x01)) {
         return false;
     }
-    delay(1);
-    
-    // 5. Устанавливаем значение Forced Mode (0x02)
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_4, BMM150_FORCED_MODE)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось установить значение Forced Mode"));
-#endif
-        return false;
-    }
-    delay(1);
-    
-    // 6. Применяем команду
-    if (!i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80 | (1 << 7))) {
+
+    // Chip ID доступен после перехода в sleep
+    unsigned long start = millis();
+    chip_id = 0;
+    while (!aux_read(BMM150_CHIP_ID, &chip_id, 1) || chip_id != 0x32) {
+        if (millis() - start >= 5) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("❌ Не удалось применить команду Forced Mode"));
+            Serial.print(F("    ❌ Chip ID BMM150: 0x"));
+            Serial.println(chip_id, HEX);
 #endif
-        return false;
-    }
-    
-    // 7. Даем время на измерение и синхронизацию через вторичный интерфейс
-    // Согласно документации BMM150, время ожидания в Forced Mode - 1-2 мс
-    delay(2);
-    
-    // 8. Проверяем, что данные готовы
-    for (int i = 0; i < 50; i++) {
-        uint8_t status = 0;
-        if (i2c_safe_read(bmi160_addr, BMI160_STATUS, &status, 1) && (status & (1 << 5))) {
-            return true;
+            return false;
         }
-        delay(1);
     }
-    
-    // Если данные не готовы, пытаемся перезапустить магнитометр
-#ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("    ⚠️ Данные не готовы. Попытка перезапуска магнитометра..."));
-#endif
-    
-    i2c_safe_write(bmi160_addr, BMI160_MAG_IF_3, 0x4B);
-    i2c_safe_write(bmi160_addr, BMI160_MAG_IF_4, 0x01);
-    i2c_safe_write(bmi160_addr, BMI160_MAG_IF_1, 0x80 | (1 << 7));
-    delay(200);
-    
-    for (int i = 0; i < 50; i++) {
-        uint8_t status = 0;
-        if (i2c_safe_read(bmi160_addr, BMI160_STATUS, &status, 1) && (status & (1 << 5))) {
-            return true;
-        }
-        delay(1);
+
+    if (!aux_write(BMM150_OPMODE, BMM150_FORCED_MODE) ||
+        !run_init_sequence(bmi160_addr, bmm150_aux_data_steps, nullptr)) {
+        return false;
     }
-    
 #ifdef IMU_BMI160_BMM150_DEBUG
-    Serial.println(F("❌ Таймаут ожидания готовности данных после Forced Mode"));
+    Serial.println(F("    ✅ Вторичный интерфейс в режиме данных"));
 #endif
-    return false;
+    return true;
 }
+#endif // IMU_FEATURE_SECONDARY
 
 /**
- * @brief Читает данные BMM150 в Forced Mode (прямое подключение)
+ * @brief Разбирает пакет данных BMM150 (DATA_X..RHALL в sample_view)
  * 
- * @param mag Массив для хранения значений магнитометра (x, y, z)
- * @param rhall Указатель на переменную для хранения значения RHALL
+ * - X и Y оси имеют 13-битное разрешение (смещение 3 бита)
+ * - Z ось имеет 14-битное разрешение (смещение 1 бит)
+ * - RHALL имеет 16-битное разрешение
+ */
+static void decode_bmm150(int16_t* mag, int16_t* rhall) {
+    mag[0] = IMU_viewMag(&sample_view, 0);
+    mag[1] = IMU_viewMag(&sample_view, 1);
+    mag[2] = IMU_viewMag(&sample_view, 2);
+    *rhall = IMU_viewRhall(&sample_view);
+}
+
+/**
+ * @brief Читает данные BMM150 в Forced Mode (прямое подключение)
  * 
  * Функция:
  * 1. Отправляет команду Forced Mode
- * 2. Читает данные с датчика
- * 3. Обрабатывает данные в формате BMM150
+ * 2. Читает данные с датчика в sample_view (на место байт MAG пакета BMI160)
+ * 3. При ошибке обнуляет их
  * 
- * Обработка данных:
- * - X и Y оси имеют 13-битное разрешение (смещение 3 бита)
- * - Z ось имеет 14-битное разрешение (смещение 1 бит)
- * - RHALL имеет 16-битное разрешение
+ * @return true если байты MAG в sample_view получили новое измерение
  * 
  * @note Используется только для BMM150, подключенного напрямую к шине I2C
  */
-static void read_bmm150_forced(int16_t* mag, int16_t* rhall) {
+static bool read_bmm150_forced() {
+    uint8_t* buf = sample_view.raw + IMU_VIEW_MAG;
+    // Измерение, запущенное read_bmm150_pipelined(), перекрывается этим
+    bmm150_pending = false;
     if (!i2c_safe_write(bmm150_addr, BMM150_OPMODE, BMM150_FORCED_MODE)) {
-        mag[0] = mag[1] = mag[2] = 0;
-        *rhall = 0;
-        return;
+        memset(buf, 0, 8);
+        return false;
     }
     delay(1);
 
-    uint8_t buf[8] = {0};
     if (!i2c_safe_read(bmm150_addr, BMM150_DATA_X, buf, 8)) {
-        mag[0] = mag[1] = mag[2] = 0;
-        *rhall = 0;
-        return;
+        memset(buf, 0, 8);
+        return false;
     }
+    return true;
+}
 
-    mag[0] = (int16_t)((buf[1] << 8) | buf[0]) >> 3;
-    mag[1] = (int16_t)((buf[3] << 8) | buf[2]) >> 3;
-    mag[2] = (int16_t)((buf[5] << 8) | buf[4]) >> 1;
-    *rhall = (int16_t)((buf[7] << 8) | buf[6]);
+/**
+ * @brief Читает результат предыдущего Forced Mode и запускает следующее измерение
+ * 
+ * @return true если байты MAG в sample_view получили новое измерение
+ * 
+ * В отличие от read_bmm150_forced() не ждет окончания измерения: оно идет
+ * между вызовами, поэтому опрос BMM150 на основной шине не задерживает
+ * чтение акселерометра и гироскопа. Данные отстают на один период опроса
+ * магнитометра, который должен быть не короче времени измерения.
+ */
+static bool read_bmm150_pipelined() {
+    bool fresh = false;
+    if (bmm150_pending) {
+        fresh = i2c_safe_read(bmm150_addr, BMM150_DATA_X, sample_view.raw + IMU_VIEW_MAG, 8);
+    }
+    bmm150_pending = i2c_safe_write(bmm150_addr, BMM150_OPMODE, BMM150_FORCED_MODE);
+    return fresh;
 }
 
 // === ПУБЛИЧНЫЕ ФУНКЦИИ ===
@@ -714,10 +1144,26 @@ static void read_bmm150_forced(int16_t* mag, int16_t* rhall) {
  * 4. Инициализация магнитометра в зависимости от обнаруженного режима
  * 
  * @note Функция выводит подробный лог инициализации в Serial (если отладка включена)
+ * @note Шаги поиска через вторичный интерфейс и полного сканирования
+ *       собираются только при IMU_FEATURE_SECONDARY и IMU_FEATURE_FULL_SCAN
+ * @note Повторный вызов начинает с нуля: теневые копии регистров и
+ *       результаты прошлого поиска сбрасываются, и все записи инициализации
+ *       доходят до датчиков, даже если те теряли питание
  */
 bool IMU_begin() {
+#if IMU_FEATURE_SERIAL_BEGIN
     Serial.begin(115200);
+#endif
     Wire.begin();
+    // Повторный запуск: датчики могли потерять питание, и теневые копии
+    // прошлой конфигурации больше не совпадают с регистрами. Результаты
+    // прошлого поиска тоже сбрасываются — иначе поиск BMM150 пропускается
+    IMU_invalidateShadow();
+    bmi160_addr = 0;
+    bmm150_addr = 0;
+    mag_mode = NONE;
+    bmm150_pending = false;
+    initialized = false;
 
     // Поиск BMI160
 #ifdef IMU_BMI160_BMM150_DEBUG
@@ -765,48 +1211,21 @@ bool IMU_begin() {
     // Настройка BMI160
     if (bmi160_addr) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-        Serial.println(F("\n2. Настройка BMI160:"));
-#endif
-        
-        if (i2c_safe_write(bmi160_addr, BMI160_ACC_CONF, config.acc_odr)) 
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  ACC_CONF задан"));
-#endif
-        if (i2c_safe_write(bmi160_addr, BMI160_ACC_RANGE, config.acc_range)) 
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  ACC_RANGE задан"));
-#endif
-        if (i2c_safe_write(bmi160_addr, BMI160_GYR_CONF, config.gyr_odr)) 
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  GYR_CONF задан"));
-#endif
-        if (i2c_safe_write(bmi160_addr, BMI160_GYR_RANGE, config.gyr_range)) 
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  GYR_RANGE задан"));
-#endif
-        
-        if (i2c_safe_write(bmi160_addr, BMI160_CMD, BMI160_CMD_SOFTRESET)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  Soft Reset"));
-#endif
-            delay(100);
-        }
-        
-        if (i2c_safe_write(bmi160_addr, BMI160_CMD, BMI160_CMD_ACC_NORMAL)) {
-#ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  ACC включен"));
+        Serial.println(F("\n2. Настройка BMI160:"));
 #endif
-            delay(10);
-        }
         
-        if (i2c_safe_write(bmi160_addr, BMI160_CMD, BMI160_CMD_GYR_NORMAL)) {
+        const uint8_t args[4] = { config.acc_odr, config.acc_range, config.gyr_odr, config.gyr_range };
+        if (run_init_sequence(bmi160_addr, bmi160_init_steps, args)) {
 #ifdef IMU_BMI160_BMM150_DEBUG
-            Serial.println(F("  GYR включен"));
+            Serial.println(F("  Soft Reset, ACC/GYR настроены и включены"));
 #endif
-            delay(10);
         }
         
         update_conversion_factors();
+#if IMU_FEATURE_AUTORANGE
+        acc_auto.pending = false;
+        gyr_auto.pending = false;
+#endif
 #ifdef IMU_BMI160_BMM150_DEBUG
         Serial.println(F("  Коэффициенты преобразования обновлены"));
 #endif
@@ -830,6 +1249,7 @@ bool IMU_begin() {
 
     // Поиск BMM150 через вторичный интерфейс
     if (bmi160_addr && !bmm150_addr) {
+#if IMU_FEATURE_SECONDARY
 #ifdef IMU_BMI160_BMM150_DEBUG
         Serial.println(F("\n4. Поиск BMM150 на вторичной шине (0x10–0x13):"));
 #endif
@@ -845,7 +1265,9 @@ bool IMU_begin() {
                 break;
             }
         }
+#endif // IMU_FEATURE_SECONDARY
         
+#if IMU_FEATURE_FULL_SCAN
         // 4.2. Если BMM150 не найден, проверяем напрямую
         if (!bmm150_addr) {
 #ifdef IMU_BMI160_BMM150_DEBUG
@@ -864,6 +1286,7 @@ bool IMU_begin() {
                 }
             }
         }
+#endif // IMU_FEATURE_FULL_SCAN
     }
 
     if (!bmm150_addr) {
@@ -890,7 +1313,8 @@ bool IMU_begin() {
  * 
  * Функция автоматически определяет режим работы магнитометра и:
  * - Если магнитометр подключен напрямую (PRIMARY), отправляет команду Forced Mode
- * - Если магнитометр подключен через BMI160 (SECONDARY), управляется через BMI160
+ * - Если магнитометр подключен через BMI160 (SECONDARY), BMI160 сам запускает
+ *   измерения с частотой MAG_CONF, и данные читаются в том же пакете
  */
 void IMU_readData(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
     // Сбрасываем данные
@@ -899,47 +1323,204 @@ void IMU_readData(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
     mag[0] = mag[1] = mag[2] = 0;
     *rhall = 0;
 
+    IMU_readChannels(IMU_CHANNEL_ALL, acc, gyr, mag, rhall);
+}
+
+/**
+ * @brief Читает выбранные каналы в sample_view минимальным пакетом
+ * 
+ * @return Маска прочитанных каналов (она же sample_view.updated)
+ * 
+ * Байты пакета остаются в sample_view.raw как есть; разбираются только
+ * значения, нужные автоматическому выбору диапазона.
+ */
+static uint8_t read_burst(uint8_t channels) {
+    uint8_t done = 0;
+
+    shadow_scrub_if_due();
+
+    bool want_mag = (channels & IMU_CHANNEL_MAG) != 0;
+
     // Чтение данных от BMI160
-    if (bmi160_addr) {
-        // Отправка Forced Mode при необходимости
-        if (mag_mode == SECONDARY) {
-            if (send_forced_mode_secondary(bmm150_addr)) {
-                delay(1);
+    // Смещения в пакете от DATA_0: MAG 0..7, GYR 8..13, ACC 14..19, TEMPERATURE 28..29
+    uint8_t first = IMU_VIEW_RAW_SIZE, last = 0;
+#if IMU_FEATURE_SECONDARY
+    if (want_mag && mag_mode == SECONDARY) { first = IMU_VIEW_MAG; last = IMU_VIEW_MAG + 8; }
+#endif
+    if (channels & IMU_CHANNEL_GYR) { if (first > IMU_VIEW_GYR) first = IMU_VIEW_GYR; last = IMU_VIEW_GYR + 6; }
+    if (channels & IMU_CHANNEL_ACC) { if (first > IMU_VIEW_ACC) first = IMU_VIEW_ACC; last = IMU_VIEW_ACC + 6; }
+    if (channels & IMU_CHANNEL_TEMP) { if (first > IMU_VIEW_TEMP) first = IMU_VIEW_TEMP; last = IMU_VIEW_TEMP + 2; }
+
+    if (bmi160_addr && first < last) {
+        uint8_t* buf = sample_view.raw;
+#if IMU_FEATURE_AUTORANGE
+        uint32_t read_us = micros();
+#endif
+        if (i2c_safe_read(bmi160_addr, BMI160_DATA_0 + first, buf + first, last - first)) {
+            uint32_t now = micros();
+            if (channels & (IMU_CHANNEL_ACC | IMU_CHANNEL_GYR)) {
+                sample_view.accgyr_us = now;
             }
-        }
-        
-        uint8_t buf[20] = {0};
-        if (i2c_safe_read(bmi160_addr, BMI160_DATA_0, buf, 20)) {
-            // Обработка данных акселерометра (16-битные значения)
-            acc[0] = (int16_t)(buf[15] << 8) | buf[14];
-            acc[1] = (int16_t)(buf[17] << 8) | buf[16];
-            acc[2] = (int16_t)(buf[19] << 8) | buf[18];
-            
-            // Обработка данных гироскопа (16-битные значения)
-            gyr[0] = (int16_t)(buf[9]  << 8) | buf[8];
-            gyr[1] = (int16_t)(buf[11] << 8) | buf[10];
-            gyr[2] = (int16_t)(buf[13] << 8) | buf[12];
-
-            // Обработка данных магнитометра, если подключен через BMI160
-            if (mag_mode == SECONDARY) {
-                mag[0] = (int16_t)(buf[1] << 8) | buf[0];
-                mag[1] = (int16_t)(buf[3] << 8) | buf[2];
-                mag[2] = (int16_t)(buf[5] << 8) | buf[4];
-                *rhall = (int16_t)(buf[7] << 8) | buf[6];
+            done = channels & (IMU_CHANNEL_ACC | IMU_CHANNEL_GYR | IMU_CHANNEL_TEMP);
+
+            if (channels & IMU_CHANNEL_ACC) {
+#if IMU_FEATURE_AUTORANGE
+                if (acc_auto.enabled) {
+                    int16_t acc[3] = { IMU_viewAcc(&sample_view, 0), IMU_viewAcc(&sample_view, 1),
+                                       IMU_viewAcc(&sample_view, 2) };
+                    autorange_step(&acc_auto, acc, false, read_us);
+                }
+#endif
+                sample_view.acc_range = config.acc_range;
+            }
+
+            if (channels & IMU_CHANNEL_GYR) {
+#if IMU_FEATURE_AUTORANGE
+                if (gyr_auto.enabled) {
+                    int16_t gyr[3] = { IMU_viewGyr(&sample_view, 0), IMU_viewGyr(&sample_view, 1),
+                                       IMU_viewGyr(&sample_view, 2) };
+                    autorange_step(&gyr_auto, gyr, true, read_us);
+                }
+#endif
+                sample_view.gyr_range = config.gyr_range;
+            }
+
+            // Температура: 0x8000 — значение недействительно
+            if (channels & IMU_CHANNEL_TEMP) {
+                temp_raw = (int16_t)((buf[IMU_VIEW_TEMP + 1] << 8) | buf[IMU_VIEW_TEMP]);
+            }
+
+#if IMU_FEATURE_SECONDARY
+            // Байты BMM150 за BMI160 — в том же пакете
+            if (want_mag && mag_mode == SECONDARY) {
+                sample_view.mag_us = now;
+                done |= IMU_CHANNEL_MAG;
             }
+#endif
         }
     }
 
-    // Чтение данных от BMM150 в Forced Mode (если подключен напрямую)
-    if (mag_mode == PRIMARY) {
-        read_bmm150_forced(mag, rhall);
+    // Чтение данных от BMM150 в Forced Mode (если подключен напрямую):
+    // с IMU_CHANNEL_MAG_NOWAIT — без ожидания измерения
+    if (want_mag && mag_mode == PRIMARY) {
+        bool fresh = (channels & IMU_CHANNEL_MAG_NOWAIT) ? read_bmm150_pipelined() : read_bmm150_forced();
+        if (fresh) {
+            sample_view.mag_us = micros();
+            done |= IMU_CHANNEL_MAG;
+        }
+    }
+    sample_view.updated = done;
+    return done;
+}
+
+/**
+ * @brief Разбирает каналы channels из sample_view в массивы вызывающего
+ */
+static void decode_channels(uint8_t channels, int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
+    // Акселерометр и гироскоп: 16-битные значения, little-endian
+    if (channels & IMU_CHANNEL_ACC) {
+        acc[0] = IMU_viewAcc(&sample_view, 0);
+        acc[1] = IMU_viewAcc(&sample_view, 1);
+        acc[2] = IMU_viewAcc(&sample_view, 2);
+    }
+    if (channels & IMU_CHANNEL_GYR) {
+        gyr[0] = IMU_viewGyr(&sample_view, 0);
+        gyr[1] = IMU_viewGyr(&sample_view, 1);
+        gyr[2] = IMU_viewGyr(&sample_view, 2);
+    }
+    if (channels & IMU_CHANNEL_MAG) {
+        decode_bmm150(mag, rhall);
+    }
+}
+
+/**
+ * @brief Считывает выбранные каналы минимальным пакетом
+ * 
+ * @return Маска каналов, получивших значения
+ * 
+ * Параметры и порядок работы — как у IMU_readChannels().
+ */
+static uint8_t read_channels(uint8_t channels, int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
+    if (!acc) channels &= ~IMU_CHANNEL_ACC;
+    if (!gyr) channels &= ~IMU_CHANNEL_GYR;
+    if (!mag || !rhall) channels &= ~IMU_CHANNEL_MAG;
+    uint8_t done = read_burst(channels);
+    decode_channels(done, acc, gyr, mag, rhall);
+    return done;
+}
+
+/**
+ * @brief Считывает выбранные каналы минимальным пакетом
+ * 
+ * @param channels Маска IMU_CHANNEL_*
+ * @param acc Массив для значений акселерометра или nullptr
+ * @param gyr Массив для значений гироскопа или nullptr
+ * @param mag Массив для значений магнитометра или nullptr
+ * @param rhall Указатель для значения RHALL или nullptr
+ * 
+ * @return Маска IMU_CHANNEL_* каналов, получивших новые значения
+ * 
+ * Функция:
+ * 1. Определяет границы пакета в регистрах DATA_0..DATA_19 по маске
+ *    (магнитометр входит в пакет только при подключении через BMI160)
+ * 2. Запускает измерение BMM150 на основной шине, только если магнитометр запрошен
+ * 3. Читает пакет одной транзакцией и разбирает запрошенные каналы
+ */
+uint8_t IMU_readChannels(uint8_t channels, int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
+    return read_channels(channels, acc, gyr, mag, rhall);
+}
+
+/**
+ * @brief Считывает выбранные каналы без копирования в массивы
+ * 
+ * @param channels Маска IMU_CHANNEL_*
+ * @return Буфер отсчета драйвера (всегда один и тот же)
+ * 
+ * Пакет читается в sample_view и не разбирается; updated — прочитанные каналы.
+ */
+const IMU_SampleView* IMU_readView(uint8_t channels) {
+    read_burst(channels);
+    return &sample_view;
+}
+
+/**
+ * @brief Возвращает последнюю прочитанную температуру BMI160
+ * 
+ * @return Сырое значение (0 = 23 °C, 1/512 °C на LSB) или IMU_TEMP_INVALID
+ */
+int16_t IMU_getTemperatureRaw() {
+    return temp_raw;
+}
+
+/**
+ * @brief Возвращает последнюю прочитанную температуру BMI160 в °C
+ */
+float IMU_getTemperature() {
+    if (temp_raw == IMU_TEMP_INVALID) {
+        return NAN;
     }
+    return 23.0f + temp_raw / 512.0f;
+}
+
+/**
+ * @brief Возвращает время получения данных последним вызовом IMU_readData()
+ * 
+ * @param accgyr_us Время чтения пакета акселерометра и гироскопа (micros())
+ * @param mag_us Время чтения магнитометра (micros())
+ * 
+ * При прямом подключении BMM150 магнитометр читается отдельной транзакцией
+ * после пакета BMI160, поэтому его время отличается.
+ */
+void IMU_getSampleTimes(uint32_t* accgyr_us, uint32_t* mag_us) {
+    *accgyr_us = sample_view.accgyr_us;
+    *mag_us = sample_view.mag_us;
 }
 
 /**
  * @brief Устанавливает диапазон измерений акселерометра
  * 
  * @param range Новое значение диапазона
+ * @return false если код диапазона не поддерживается (регистр не изменяется)
  * 
  * Функция обновляет внутреннюю конфигурацию и пересчитывает коэффициенты преобразования
  * 
@@ -949,18 +1530,26 @@ void IMU_readData(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
  *       0x08: ±8g (4096 LSB/g)
  *       0x0C: ±16g (2048 LSB/g)
  */
-void IMU_setAccelRange(uint8_t range) {
+bool IMU_setAccelRange(uint8_t range) {
+    if (!acc_range_valid(range)) {
+        return false;
+    }
     if (bmi160_addr) {
         i2c_safe_write(bmi160_addr, BMI160_ACC_RANGE, range);
         config.acc_range = range;
+#if IMU_FEATURE_AUTORANGE
+        acc_auto.pending = false;
+#endif
         update_conversion_factors();
     }
+    return true;
 }
 
 /**
  * @brief Устанавливает диапазон измерений гироскопа
  * 
  * @param range Новое значение диапазона
+ * @return false если код диапазона не поддерживается (регистр не изменяется)
  * 
  * Функция обновляет внутреннюю конфигурацию и пересчитывает коэффициенты преобразования
  * 
@@ -971,12 +1560,101 @@ void IMU_setAccelRange(uint8_t range) {
  *       0x03: ±250°/s (131.072 LSB/°/s)
  *       0x04: ±125°/s (262.144 LSB/°/s)
  */
-void IMU_setGyroRange(uint8_t range) {
+bool IMU_setGyroRange(uint8_t range) {
+    if (!gyr_range_valid(range)) {
+        return false;
+    }
     if (bmi160_addr) {
         i2c_safe_write(bmi160_addr, BMI160_GYR_RANGE, range);
         config.gyr_range = range;
+#if IMU_FEATURE_AUTORANGE
+        gyr_auto.pending = false;
+#endif
+        update_conversion_factors();
+    }
+    return true;
+}
+
+/**
+ * @brief Включает автоматический выбор диапазона
+ * 
+ * @param channels IMU_CHANNEL_ACC, IMU_CHANNEL_GYR, их сочетание или 0 (выключить)
+ * 
+ * Функция:
+ * 1. Запоминает, для каких датчиков диапазон выбирается автоматически
+ * 2. Отменяет незавершенное переключение у датчиков, для которых режим выключен
+ * 
+ * Решение о переключении принимается в IMU_readChannels() по каждому
+ * прочитанному отсчету: шире — сразу, как только модуль любой оси достиг
+ * IMU_AUTORANGE_UP; уже — если в течение IMU_AUTORANGE_HOLD_MS все отсчеты
+ * были ниже IMU_AUTORANGE_DOWN.
+ */
+#if IMU_FEATURE_AUTORANGE
+void IMU_setAutoRange(uint8_t channels) {
+    acc_auto.enabled = (channels & IMU_CHANNEL_ACC) != 0;
+    gyr_auto.enabled = (channels & IMU_CHANNEL_GYR) != 0;
+    acc_auto.quiet = gyr_auto.quiet = false;
+    if (!acc_auto.enabled && acc_auto.pending) {
+        // Регистр уже записан: масштаб должен следовать за ним
+        config.acc_range = acc_auto.next_range;
+        update_conversion_factors();
+        acc_auto.pending = false;
+    }
+    if (!gyr_auto.enabled && gyr_auto.pending) {
+        config.gyr_range = gyr_auto.next_range;
         update_conversion_factors();
+        gyr_auto.pending = false;
+    }
+}
+#endif
+
+/**
+ * @brief Возвращает диапазоны, в которых измерен последний прочитанный отсчет
+ * 
+ * @param acc_range Код диапазона акселерометра (0x03, 0x05, 0x08, 0x0C) или nullptr
+ * @param gyr_range Код диапазона гироскопа (0x00-0x04) или nullptr
+ */
+void IMU_getSampleRanges(uint8_t* acc_range, uint8_t* gyr_range) {
+    if (acc_range) {
+        *acc_range = sample_view.acc_range;
+    }
+    if (gyr_range) {
+        *gyr_range = sample_view.gyr_range;
+    }
+}
+
+/**
+ * @brief Задает полную конфигурацию акселерометра и гироскопа
+ * 
+ * @param cfg Новая конфигурация (значения регистров ACC_CONF, ACC_RANGE, GYR_CONF, GYR_RANGE)
+ * @return false если код диапазона не поддерживается (конфигурация не изменяется)
+ * 
+ * До IMU_begin() конфигурация только запоминается и применяется при инициализации.
+ * После инициализации регистры записываются сразу.
+ */
+bool IMU_setConfig(const SensorConfig& cfg) {
+    if (!acc_range_valid(cfg.acc_range) || !gyr_range_valid(cfg.gyr_range)) {
+        return false;
+    }
+    config = cfg;
+#if IMU_FEATURE_AUTORANGE
+    acc_auto.pending = false;
+    gyr_auto.pending = false;
+#endif
+    if (bmi160_addr) {
+        // ACC_CONF..GYR_RANGE — соседние регистры, записываются одной транзакцией
+        const uint8_t regs[4] = { config.acc_odr, config.acc_range, config.gyr_odr, config.gyr_range };
+        reg_write(bmi160_addr, BMI160_ACC_CONF, regs, 4);
     }
+    update_conversion_factors();
+    return true;
+}
+
+/**
+ * @brief Возвращает текущую конфигурацию акселерометра и гироскопа
+ */
+SensorConfig IMU_getConfig() {
+    return config;
 }
 
 /**
@@ -1002,6 +1680,64 @@ bool IMU_isInitialized() {
     return initialized;
 }
 
+/**
+ * @brief Частота выдачи данных по значению регистра ACC_CONF/GYR_CONF (Гц)
+ * 
+ * Биты 3:0 — код ODR: 100 Гц · 2^(код - 8), код 1 = 25/32 Гц
+ */
+static float odr_hz(uint8_t conf) {
+    uint8_t code = conf & 0x0F;
+    if (code == 0) {
+        return 0.0f;
+    }
+    return code >= 8 ? 100.0f * (1u << (code - 8)) : 100.0f / (1u << (8 - code));
+}
+
+/**
+ * @brief Настраивает сроки опроса; сетка перезапускается только при смене частоты
+ */
+static void set_poll_rates(PollSchedule* ps, float accgyr_hz, float mag_hz) {
+    if (accgyr_hz != ps->accgyr_hz) {
+        IMU_schedInit(&ps->accgyr, accgyr_hz, IMU_SCHED_CATCH_UP);
+        ps->accgyr_hz = accgyr_hz;
+    }
+    if (mag_hz != ps->mag_hz) {
+        // Магнитометру важен только последний отсчет: пропущенные сроки не догоняются
+        IMU_schedInit(&ps->mag, mag_hz, IMU_SCHED_SKIP);
+        ps->mag_hz = mag_hz;
+    }
+}
+
+/**
+ * @brief Опрашивает датчики, у которых подошел срок, в sample_view
+ * 
+ * @param ps Сроки опроса вызывающей функции
+ * @return Маска обновленных каналов (она же sample_view.updated)
+ * 
+ * Функция:
+ * 1. Акселерометр и гироскоп читаются по сроку ps->accgyr
+ * 2. Магнитометр — по своему сроку ps->mag: за BMI160 его 8 байт
+ *    добавляются к тому же пакету, на основной шине читается результат
+ *    предыдущего Forced Mode и запускается следующий (без ожидания)
+ */
+static uint8_t poll_sensors(PollSchedule* ps) {
+    uint8_t channels = 0;
+    if (IMU_schedDue(&ps->accgyr)) {
+        channels |= IMU_CHANNEL_ACC | IMU_CHANNEL_GYR;
+    }
+    bool mag_due = mag_mode != NONE && IMU_schedDue(&ps->mag);
+    if (mag_due && mag_mode == SECONDARY) {
+        channels |= IMU_CHANNEL_MAG;
+    }
+    uint8_t updated = channels ? read_burst(channels) : 0;
+    if (mag_due && mag_mode == PRIMARY && read_bmm150_pipelined()) {
+        sample_view.mag_us = micros();
+        updated |= IMU_CHANNEL_MAG;
+    }
+    sample_view.updated = updated;
+    return updated;
+}
+
 /**
  * @brief Читает данные сенсоров с заданной частотой, усредняя результаты
  * 
@@ -1012,77 +1748,273 @@ bool IMU_isInitialized() {
  * @param frequency Частота опроса (Гц)
  * 
  * Функция:
- * 1. Устанавливает максимальную частоту измерений для всех датчиков
- * 2. Считывает данные с максимально возможной частотой
- * 3. Усредняет данные для достижения заданной частоты
- * 4. Всегда возвращает последнее прочитанное значение, если новые данные недоступны
+ * 1. Ограничивает частоту возможностями акселерометра и гироскопа
+ * 2. Опрашивает акселерометр и гироскоп с заданной частотой, а магнитометр —
+ *    со своей (не выше MAX_MAG_FREQUENCY), по своим срокам, независимым
+ *    от IMU_pollSensors()
+ * 3. Всегда возвращает последнее прочитанное значение каждого датчика
  * 
  * @note Функция НИКОГДА не возвращает нулевые значения, если есть предыдущие данные
  * @note Если данные не обновляются, возвращается последнее прочитанное значение
+ * @note Сроки — на сетке micros() с дробным периодом: 300 Гц дают 300 чтений
+ *       в секунду, опоздавшие вызовы отрабатываются подряд (IMU_SCHED_CATCH_UP)
  */
 void IMU_readDataWithFrequency(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall, float frequency) {
     // Проверка валидности частоты
     if (frequency <= 0) {
         frequency = 10.0f; // Минимальная частота 10 Гц
     }
-    // Определяем максимальную доступную частоту
+    // Определяем максимальную доступную частоту: магнитометр опрашивается отдельно
     float max_frequency = MAX_ACC_FREQUENCY;
     if (max_frequency > MAX_GYR_FREQUENCY) {
         max_frequency = MAX_GYR_FREQUENCY;
     }
-    if (mag_mode != NONE && max_frequency > MAX_MAG_FREQUENCY) {
-        max_frequency = MAX_MAG_FREQUENCY;
-    }
     // Если заданная частота выше максимальной, используем максимальную
     if (frequency > max_frequency) {
         frequency = max_frequency;
     }
-    // Вычисляем интервал между усреднениями
-    unsigned long interval = (unsigned long)(1000.0f / frequency);
-    
-    // Статические переменные для хранения последних валидных значений
-    static int16_t last_acc[3] = {0};
-    static int16_t last_gyr[3] = {0};
-    static int16_t last_mag[3] = {0};
-    static int16_t last_rhall = 0;
-    
-    // Статическая переменная для отслеживания времени последнего чтения данных
-    static unsigned long last_read_time = 0;
-    
-    // Текущее время
-    unsigned long current_time = millis();
-    
-    // Обновляем данные только если прошло достаточно времени
-    if (current_time - last_read_time >= interval || last_read_time == 0) {
-        // Считываем данные
-        int16_t acc_raw[3], gyr_raw[3], mag_raw[3];
-        int16_t rhall_raw;
-        IMU_readData(acc_raw, gyr_raw, mag_raw, &rhall_raw);
-        
-        // Обновляем последние значения
-        last_acc[0] = acc_raw[0];
-        last_acc[1] = acc_raw[1];
-        last_acc[2] = acc_raw[2];
-        last_gyr[0] = gyr_raw[0];
-        last_gyr[1] = gyr_raw[1];
-        last_gyr[2] = gyr_raw[2];
-        last_mag[0] = mag_raw[0];
-        last_mag[1] = mag_raw[1];
-        last_mag[2] = mag_raw[2];
-        last_rhall = rhall_raw;
-        
-        last_read_time = current_time; // Обновляем время последнего чтения
-    }
-    
+    set_poll_rates(&freq_poll, frequency, frequency < MAX_MAG_FREQUENCY ? frequency : MAX_MAG_FREQUENCY);
+
+    // Обновляются только опрошенные датчики; байты остальных остаются
+    // в sample_view с их прошлого чтения
+    poll_sensors(&freq_poll);
+
     // ВСЕГДА возвращаем последние прочитанные значения
-    acc[0] = last_acc[0];
-    acc[1] = last_acc[1];
-    acc[2] = last_acc[2];
-    gyr[0] = last_gyr[0];
-    gyr[1] = last_gyr[1];
-    gyr[2] = last_gyr[2];
-    mag[0] = last_mag[0];
-    mag[1] = last_mag[1];
-    mag[2] = last_mag[2];
-    *rhall = last_rhall;
-}
\ No newline at end of file
+    decode_channels(IMU_CHANNEL_ALL, acc, gyr, mag, rhall);
+}
+
+/**
+ * @brief Задает частоты опроса для IMU_pollSensors()
+ * 
+ * @param accgyr_hz Частота опроса акселерометра и гироскопа (Гц) или 0 —
+ *                  большая из ODR акселерометра и гироскопа по текущей конфигурации
+ * @param mag_hz Частота опроса магнитометра (Гц) или 0 — MAX_MAG_FREQUENCY
+ */
+void IMU_setPollRates(float accgyr_hz, float mag_hz) {
+    if (accgyr_hz <= 0) {
+        float acc_hz = odr_hz(config.acc_odr);
+        float gyr_hz = odr_hz(config.gyr_odr);
+        accgyr_hz = acc_hz > gyr_hz ? acc_hz : gyr_hz;
+    }
+    if (accgyr_hz > MAX_GYR_FREQUENCY) {
+        accgyr_hz = MAX_GYR_FREQUENCY;
+    }
+    if (mag_hz <= 0 || mag_hz > MAX_MAG_FREQUENCY) {
+        mag_hz = MAX_MAG_FREQUENCY;
+    }
+    set_poll_rates(&sensor_poll, accgyr_hz, mag_hz);
+}
+
+/**
+ * @brief Опрашивает каждый датчик с его собственной частотой
+ * 
+ * @param acc Массив акселерометра (x, y, z)
+ * @param gyr Массив гироскопа (x, y, z)
+ * @param mag Массив магнитометра (x, y, z)
+ * @param rhall Указатель для RHALL
+ * @return Маска IMU_CHANNEL_* датчиков, получивших новые данные
+ * 
+ * Массивы датчиков, которые не опрашивались, не изменяются. Время
+ * последнего обновления каждого датчика — IMU_getSampleTimes().
+ */
+uint8_t IMU_pollSensors(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall) {
+    uint8_t updated = IMU_pollSensorsView()->updated;
+    decode_channels(updated, acc, gyr, mag, rhall);
+    return updated;
+}
+
+/**
+ * @brief IMU_pollSensors() без копирования в массивы
+ * 
+ * @return Буфер отсчета драйвера; updated — датчики, у которых подошел срок
+ */
+const IMU_SampleView* IMU_pollSensorsView() {
+    if (sensor_poll.accgyr_hz == 0.0f) {
+        IMU_setPollRates(0, 0);
+    }
+    poll_sensors(&sensor_poll);
+    return &sample_view;
+}
+
+/**
+ * @brief Статистика сроков опроса акселерометра и гироскопа IMU_readDataWithFrequency()
+ */
+void IMU_getFrequencyStats(IMU_SchedStats* st) {
+    IMU_schedStats(&freq_poll.accgyr, st);
+}
+
+/**
+ * @brief Статистика сроков опроса акселерометра и гироскопа IMU_pollSensors()
+ */
+void IMU_getPollStats(IMU_SchedStats* st) {
+    IMU_schedStats(&sensor_poll.accgyr, st);
+}
+
+#if IMU_FEATURE_SECONDARY
+/**
+ * @brief Читает регистры BMM150 через вторичный интерфейс BMI160
+ * 
+ * @param reg Первый регистр BMM150
+ * @param buf Буфер для данных
+ * @param len Количество байт (блок читается пакетами по 8, 6, 2, 1 байт)
+ * @return false если BMM150 не подключен через BMI160 или обмен не удался
+ * 
+ * Интерфейс на время обмена переводится в ручной режим и затем
+ * возвращается в режим данных.
+ */
+bool IMU_auxRead(uint8_t reg, uint8_t* buf, uint8_t len) {
+    if (!aux_manual_begin()) {
+        return false;
+    }
+    bool ok = aux_read(reg, buf, len);
+    return aux_manual_end(false) && ok;
+}
+
+/**
+ * @brief Записывает регистры BMM150 через вторичный интерфейс BMI160
+ * 
+ * @param reg Первый регистр BMM150
+ * @param data Данные
+ * @param len Количество байт (по одной операции интерфейса на байт)
+ * @return false если BMM150 не подключен через BMI160 или обмен не удался
+ */
+bool IMU_auxWrite(uint8_t reg, const uint8_t* data, uint8_t len) {
+    if (!aux_manual_begin()) {
+        return false;
+    }
+    bool ok = true;
+    for (uint8_t i = 0; i < len && ok; i++) {
+        ok = aux_write((uint8_t)(reg + i), data[i]);
+    }
+    return aux_manual_end(true) && ok;
+}
+#endif // IMU_FEATURE_SECONDARY
+
+/**
+ * @brief Подменяет шину, через которую драйвер обращается к датчикам
+ * 
+ * @param new_bus Реализация шины или nullptr для возврата к Wire
+ */
+void IMU_setBus(const IMU_Bus* new_bus) {
+    bus = new_bus ? new_bus : &wire_bus;
+    IMU_invalidateShadow();
+}
+
+/**
+ * @brief Устанавливает обработчик транзакций шины
+ * 
+ * @param hook Функция, вызываемая после каждой транзакции, или nullptr для отключения
+ */
+void IMU_setBusHook(IMU_BusHook hook) {
+    bus_hook = hook;
+}
+
+/**
+ * @brief Включает проверку записей конфигурации чтением при инициализации
+ * 
+ * @param enable true — после записи регистров конфигурации они читаются и сравниваются
+ */
+void IMU_setInitVerify(bool enable) {
+    init_verify = enable;
+}
+
+/**
+ * @brief Возвращает счетчики обмена по шине
+ * 
+ * @param stats Структура для счетчиков
+ */
+void IMU_getBusStats(IMU_BusStats* stats) {
+    *stats = bus_stats;
+}
+
+/**
+ * @brief Обнуляет счетчики обмена по шине
+ */
+void IMU_resetBusStats() {
+    memset(&bus_stats, 0, sizeof(bus_stats));
+}
+
+/**
+ * @brief Включает или выключает теневые копии регистров
+ * 
+ * @param enable false — каждая запись и чтение конфигурации идет на шину
+ */
+void IMU_setShadowEnabled(bool enable) {
+#if IMU_FEATURE_SHADOW
+    shadow_enabled = enable;
+    IMU_invalidateShadow();
+#else
+    (void)enable;
+#endif
+}
+
+/**
+ * @brief Сбрасывает теневые копии всех устройств
+ */
+void IMU_invalidateShadow() {
+#if IMU_FEATURE_SHADOW
+    bmi160_shadow.valid = 0;
+    bmm150_shadow.valid = 0;
+#endif
+}
+
+/**
+ * @brief Задает период сверки теневых копий с устройствами
+ * 
+ * @param interval_ms Период в мс или 0 для отключения
+ */
+void IMU_setShadowScrub(uint32_t interval_ms) {
+#if IMU_FEATURE_SHADOW
+    shadow_scrub_interval = interval_ms;
+    shadow_last_scrub = millis();
+#else
+    (void)interval_ms;
+#endif
+}
+
+/**
+ * @brief Читает регистр BMI160 (конфигурация — из теневой копии)
+ * 
+ * @param reg Регистр
+ * @param value Указатель для значения
+ * @return false если BMI160 не найден или чтение не удалось
+ */
+bool IMU_readRegister(uint8_t reg, uint8_t* value) {
+    if (!bmi160_addr) {
+        return false;
+    }
+    return i2c_safe_read(bmi160_addr, reg, value, 1);
+}
+
+/**
+ * @brief Записывает регистр BMI160 (запись того же значения пропускается)
+ * 
+ * @param reg Регистр
+ * @param value Значение
+ * @return false если BMI160 не найден или запись не удалась
+ */
+bool IMU_writeRegister(uint8_t reg, uint8_t value) {
+    if (!bmi160_addr) {
+        return false;
+    }
+    return reg_write(bmi160_addr, reg, &value, 1);
+}
+
+/**
+ * @brief Изменяет битовое поле регистра BMI160 (чтение-изменение-запись)
+ * 
+ * @param reg Регистр
+ * @param mask Маска изменяемых бит
+ * @param value Новое значение бит (в позиции маски)
+ * @return false если BMI160 не найден или обмен не удался
+ * 
+ * Для регистров конфигурации чтение и, если поле не меняется, запись
+ * выполняются без обращения к шине.
+ */
+bool IMU_writeRegisterBits(uint8_t reg, uint8_t mask, uint8_t value) {
+    uint8_t cur;
+    if (!IMU_readRegister(reg, &cur)) {
+        return false;
+    }
+    return IMU_writeRegister(reg, (uint8_t)((cur & ~mask) | (value & mask)));
+}
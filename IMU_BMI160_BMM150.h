@@ -24,6 +24,9 @@
  * 
  * @note Эта библиотека совместима с Arduino IDE и другими средами, поддерживающими C++
  * @note Для включения отладочного вывода добавьте #define IMU_BMI160_BMM150_DEBUG
+ *       в IMU_Features.h или флаги компилятора
+ * @note Состав драйвера (вторичный интерфейс, полное сканирование, автодиапазон,
+ *       теневые копии) выбирается при сборке, см. IMU_Features.h
  * 
  * Документация:
  * - BMI160: BMM150 DOC012143196.pdf
@@ -35,6 +38,7 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "IMU_Features.h"
 
 // Определение режимов работы магнитометра
 enum MagMode { 
@@ -51,6 +55,110 @@ struct SensorConfig {
     uint8_t gyr_range;   // Диапазон измерений гироскопа
 };
 
+// Каналы IMU (маски для выборочного чтения и подписок)
+#define IMU_CHANNEL_ACC 0x01
+#define IMU_CHANNEL_GYR 0x02
+#define IMU_CHANNEL_MAG 0x04  // x, y, z и RHALL
+#define IMU_CHANNEL_ALL (IMU_CHANNEL_ACC | IMU_CHANNEL_GYR | IMU_CHANNEL_MAG)
+#define IMU_CHANNEL_TEMP 0x08 // Температура BMI160 (не входит в IMU_CHANNEL_ALL, см. IMU_getTemperatureRaw)
+// Флаг чтения вместе с IMU_CHANNEL_MAG: BMM150 на основной шине читается без
+// ожидания — результат предыдущего Forced Mode (как в IMU_pollSensors)
+#define IMU_CHANNEL_MAG_NOWAIT 0x10
+
+// Значение IMU_getTemperatureRaw(), пока температура не прочитана или недействительна
+#define IMU_TEMP_INVALID ((int16_t)0x8000)
+
+// Один отсчет всех каналов IMU в сырых единицах датчиков
+struct IMU_Sample {
+    uint32_t t_us;   // Время получения отсчета (micros())
+    int16_t acc[3];  // Акселерометр (x, y, z)
+    int16_t gyr[3];  // Гироскоп (x, y, z)
+    int16_t mag[3];  // Магнитометр (x, y, z)
+    int16_t rhall;   // RHALL магнитометра
+};
+
+// Смещения в IMU_SampleView::raw: образ регистров BMI160 с DATA_0 (0x04)
+#define IMU_VIEW_MAG 0        // BMM150 DATA_X..RHALL, 8 байт (за BMI160 или на основной шине)
+#define IMU_VIEW_GYR 8        // Гироскоп x, y, z, little-endian
+#define IMU_VIEW_ACC 14       // Акселерометр x, y, z, little-endian
+#define IMU_VIEW_TEMP 28      // Температура (только после чтения с IMU_CHANNEL_TEMP)
+#define IMU_VIEW_RAW_SIZE 30
+
+// Отсчет в буфере драйвера (IMU_readView, IMU_pollSensorsView): байты пакета как
+// есть и сведения о них. Оси разбираются по запросу функциями IMU_view*()
+struct IMU_SampleView {
+    uint8_t raw[IMU_VIEW_RAW_SIZE]; // Байты каждого канала — с его последнего чтения
+    uint8_t updated;                // IMU_CHANNEL_* каналов, прочитанных последним вызовом
+    uint8_t acc_range;              // Диапазон, в котором измерен акселерометр в raw
+    uint8_t gyr_range;              // Диапазон, в котором измерен гироскоп в raw
+    uint32_t accgyr_us;             // Время чтения акселерометра и гироскопа (micros())
+    uint32_t mag_us;                // Время чтения магнитометра (micros())
+};
+
+// Ось акселерометра (0 — x, 1 — y, 2 — z), сырое значение
+inline int16_t IMU_viewAcc(const IMU_SampleView* v, uint8_t axis) {
+    const uint8_t* p = v->raw + IMU_VIEW_ACC + 2 * axis;
+    return (int16_t)((p[1] << 8) | p[0]);
+}
+
+// Ось гироскопа, сырое значение
+inline int16_t IMU_viewGyr(const IMU_SampleView* v, uint8_t axis) {
+    const uint8_t* p = v->raw + IMU_VIEW_GYR + 2 * axis;
+    return (int16_t)((p[1] << 8) | p[0]);
+}
+
+// Ось магнитометра: x и y — 13 бит (сдвиг 3), z — 14 бит (сдвиг 1)
+inline int16_t IMU_viewMag(const IMU_SampleView* v, uint8_t axis) {
+    const uint8_t* p = v->raw + IMU_VIEW_MAG + 2 * axis;
+    return (int16_t)((p[1] << 8) | p[0]) >> (axis == 2 ? 1 : 3);
+}
+
+// RHALL магнитометра
+inline int16_t IMU_viewRhall(const IMU_SampleView* v) {
+    return (int16_t)((v->raw[IMU_VIEW_MAG + 7] << 8) | v->raw[IMU_VIEW_MAG + 6]);
+}
+
+// Тип транзакции на шине (см. IMU_BusEvent)
+enum IMU_BusOp {
+    IMU_BUS_PROBE = 0, // Проверка наличия устройства (адрес + регистр, без данных)
+    IMU_BUS_WRITE = 1, // Запись len байт начиная с регистра reg
+    IMU_BUS_READ  = 2  // Чтение len байт начиная с регистра reg
+};
+
+// Интерфейс шины, через который драйвер выполняет все обращения к датчикам.
+// По умолчанию используется Wire; IMU_setBus() позволяет подставить другую
+// реализацию (воспроизведение записи, модель регистров на хосте и т.п.).
+// read заполняет buf только при успехе: драйвер читает пакет прямо в буфер
+// отсчета, и неудачное чтение не должно портить прошлые значения
+struct IMU_Bus {
+    bool (*probe)(uint8_t addr, uint8_t reg);
+    bool (*write)(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len);
+    bool (*read)(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len);
+};
+
+// Описание одной выполненной транзакции (передается в IMU_BusHook)
+struct IMU_BusEvent {
+    uint32_t t_us;        // Время начала транзакции (micros())
+    uint8_t op;           // IMU_BusOp
+    uint8_t addr;         // Адрес устройства
+    uint8_t reg;          // Начальный регистр
+    uint8_t len;          // Длина данных (0 для PROBE)
+    bool ok;              // Результат транзакции
+    const uint8_t* data;  // Записанные/прочитанные байты (nullptr для PROBE и неудачного чтения)
+};
+
+// Обработчик, вызываемый после каждой транзакции на шине
+typedef void (*IMU_BusHook)(const IMU_BusEvent* ev);
+
+// Счетчики обмена по шине (см. IMU_getBusStats)
+struct IMU_BusStats {
+    uint32_t transactions;    // Выполнено транзакций
+    uint32_t bytes;           // Передано байт на линии (адреса, регистры, данные)
+    uint32_t writes_skipped;  // Записей, пропущенных теневой копией (значение не менялось)
+    uint32_t reads_cached;    // Чтений конфигурации, обслуженных из теневой копии
+    uint32_t scrub_repairs;   // Регистров, восстановленных при сверке теневой копии
+};
+
 // Константы преобразования значений сенсоров в физические единицы
 extern float ACC_LSB;  // Коэффициент преобразования для акселерометра (LSB/g)
 extern float GYR_LSB;  // Коэффициент преобразования для гироскопа (LSB/°/s)
@@ -84,12 +192,61 @@ bool IMU_begin();
  * 
  * Функция автоматически определяет режим работы магнитометра и:
  * - Если магнитометр подключен напрямую (PRIMARY), отправляет команду Forced Mode
- * - Если магнитометр подключен через BMI160 (SECONDARY), управляется через BMI160
+ * - Если магнитометр подключен через BMI160 (SECONDARY), BMI160 сам запускает
+ *   измерения с частотой MAG_CONF, и данные читаются в том же пакете
  * 
  * @note Данные возвращаются в "сыром" формате (сырые значения сенсоров)
  */
 void IMU_readData(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall);
 
+/**
+ * @brief Считывает только выбранные каналы
+ * 
+ * @param channels Маска IMU_CHANNEL_*
+ * @param acc Акселерометр (x, y, z) или nullptr, если канал не запрошен
+ * @param gyr Гироскоп (x, y, z) или nullptr
+ * @param mag Магнитометр (x, y, z) или nullptr
+ * @param rhall RHALL или nullptr
+ * @return Маска IMU_CHANNEL_* каналов, получивших новые значения: без
+ *         канала, если чтение не удалось или датчик не найден
+ * 
+ * Из регистров данных BMI160 (MAG 0x04–0x0B, GYR 0x0C–0x11, ACC 0x12–0x17)
+ * читается наименьший непрерывный пакет, покрывающий запрошенные каналы:
+ * только гироскоп — 6 байт вместо 20. Если магнитометр подключен напрямую
+ * и не запрошен, измерение BMM150 (Forced Mode) не запускается. Незапрошенные выходы
+ * не изменяются. С IMU_CHANNEL_TEMP пакет продлевается до регистров
+ * температуры 0x20–0x21, значение доступно через IMU_getTemperatureRaw().
+ * С IMU_CHANNEL_MAG_NOWAIT измерение BMM150 на основной шине не ожидается:
+ * читается результат предыдущего запуска (при первом вызове канала нет).
+ */
+uint8_t IMU_readChannels(uint8_t channels, int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall);
+
+/**
+ * @brief Возвращает последнюю прочитанную температуру BMI160 (IMU_CHANNEL_TEMP)
+ * 
+ * @return Сырое значение: 0 = 23 °C, 1/512 °C на LSB; IMU_TEMP_INVALID,
+ *         если температура еще не читалась или датчик ее не обновил
+ */
+int16_t IMU_getTemperatureRaw();
+
+/**
+ * @brief Последняя прочитанная температура BMI160 в °C (NAN, если недействительна)
+ */
+float IMU_getTemperature();
+
+/**
+ * @brief Возвращает время последнего обновления каждого датчика
+ * 
+ * @param accgyr_us Время чтения акселерометра и гироскопа (micros())
+ * @param mag_us Время чтения магнитометра (micros())
+ * 
+ * При опросе IMU_pollSensors() датчики обновляются с разной частотой, и время
+ * каждого меняется только при его чтении. При прямом подключении BMM150 (PRIMARY) магнитометр читается отдельной
+ * транзакцией после BMI160, поэтому значения в одном вызове относятся к
+ * разным моментам. Для выравнивания используйте IMU_Resample.h.
+ */
+void IMU_getSampleTimes(uint32_t* accgyr_us, uint32_t* mag_us);
+
 /**
  * @brief Устанавливает диапазон измерений акселерометра
  * 
@@ -102,8 +259,10 @@ void IMU_readData(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall);
  * 0x0C: ±16g (2048 LSB/g)
  * 
  * Функция обновляет внутренние коэффициенты преобразования
+ * 
+ * @return false если код диапазона не поддерживается (регистр не изменяется)
  */
-void IMU_setAccelRange(uint8_t range);
+bool IMU_setAccelRange(uint8_t range);
 
 /**
  * @brief Устанавливает диапазон измерений гироскопа
@@ -118,8 +277,68 @@ void IMU_setAccelRange(uint8_t range);
  * 0x04: ±125°/s (262.144 LSB/°/s)
  * 
  * Функция обновляет внутренние коэффициенты преобразования
+ * 
+ * @return false если код диапазона не поддерживается (регистр не изменяется)
+ */
+bool IMU_setGyroRange(uint8_t range);
+
+#if IMU_FEATURE_AUTORANGE
+// Автоматический выбор диапазона (IMU_setAutoRange)
+#ifndef IMU_AUTORANGE_UP
+#define IMU_AUTORANGE_UP 29491      // Модуль отсчета, при котором диапазон расширяется (90% шкалы)
+#endif
+#ifndef IMU_AUTORANGE_DOWN
+#define IMU_AUTORANGE_DOWN 6553     // Ниже — кандидат на сужение (40% шкалы более узкого диапазона)
+#endif
+#ifndef IMU_AUTORANGE_HOLD_MS
+#define IMU_AUTORANGE_HOLD_MS 250   // Время (мс) ниже IMU_AUTORANGE_DOWN перед сужением
+#endif
+
+/**
+ * @brief Включает автоматический выбор диапазона акселерометра и/или гироскопа
+ * 
+ * @param channels IMU_CHANNEL_ACC, IMU_CHANNEL_GYR, их сочетание или 0 (выключить)
+ * 
+ * Диапазон расширяется на шаг, как только модуль любой оси достигает
+ * IMU_AUTORANGE_UP, и сужается на шаг, если все отсчеты за
+ * IMU_AUTORANGE_HOLD_MS были ниже IMU_AUTORANGE_DOWN. Пороги разнесены:
+ * после сужения сигнал занимает не больше 40% шкалы, что исключает дребезг.
+ * 
+ * Переключение не останавливает чтение. Новый масштаб вступает в силу
+ * на первом отсчете, измеренном после записи регистра: ACC_LSB/GYR_LSB
+ * и IMU_getSampleRanges() меняются ровно на этом отсчете, поэтому перевод
+ * в физические единицы сразу после чтения остается верным.
  */
-void IMU_setGyroRange(uint8_t range);
+void IMU_setAutoRange(uint8_t channels);
+#endif
+
+/**
+ * @brief Диапазоны, в которых измерен последний прочитанный отсчет
+ * 
+ * @param acc_range Код диапазона акселерометра или nullptr
+ * @param gyr_range Код диапазона гироскопа или nullptr
+ * 
+ * @note Для отсчетов, которые переводятся в единицы позже (очередь, журнал),
+ *       сохраняйте метку вместе с отсчетом
+ */
+void IMU_getSampleRanges(uint8_t* acc_range, uint8_t* gyr_range);
+
+/**
+ * @brief Задает полную конфигурацию акселерометра и гироскопа
+ * 
+ * @param cfg Значения регистров ACC_CONF, ACC_RANGE, GYR_CONF, GYR_RANGE
+ * @return false если код диапазона не поддерживается (конфигурация не изменяется)
+ * 
+ * До IMU_begin() конфигурация запоминается и применяется при инициализации,
+ * после — регистры записываются сразу. Для проверки на этапе компиляции
+ * используйте шаблон Imu<> из IMU_Config.h.
+ */
+bool IMU_setConfig(const SensorConfig& cfg);
+
+/**
+ * @brief Возвращает текущую конфигурацию акселерометра и гироскопа
+ */
+SensorConfig IMU_getConfig();
 
 /**
  * @brief Возвращает текущий режим работы магнитометра
@@ -155,9 +374,234 @@ bool IMU_isInitialized();
  * 3. Усредняет данные для достижения заданной частоты
  * 4. Обрабатывает возможные различия в скорости работы датчиков
  * 
- * @note Функция автоматически определяет оптимальный режим работы
+ * @note Частоту ограничивают только акселерометр и гироскоп (до 1600 Гц).
+ *       Магнитометр опрашивается со своей частотой, не выше 100 Гц, и между
+ *       его чтениями возвращается последнее значение (см. IMU_pollSensors)
  * @note Если заданная частота выше возможной, используется максимальная
+ * @note Сроки чтения — абсолютные, по micros() (IMU_Sched.h, политика
+ *       IMU_SCHED_CATCH_UP): опоздание вызова не накапливается в дрейф частоты
  */
 void IMU_readDataWithFrequency(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall, float frequency);
 
+/**
+ * @brief Задает частоты опроса IMU_pollSensors() для каждого датчика
+ * 
+ * @param accgyr_hz Акселерометр и гироскоп (Гц); 0 — по ODR текущей конфигурации
+ * @param mag_hz Магнитометр (Гц); 0 или больше 100 — 100 Гц (частота измерений BMM150)
+ * 
+ * @note У IMU_readDataWithFrequency() свои сроки: она задает их сама,
+ *       и вызовы одной функции не сбивают сроки другой
+ */
+void IMU_setPollRates(float accgyr_hz, float mag_hz);
+
+/**
+ * @brief Опрашивает каждый датчик с его собственной частотой
+ * 
+ * @param acc Массив акселерометра (x, y, z)
+ * @param gyr Массив гироскопа (x, y, z)
+ * @param mag Массив магнитометра (x, y, z)
+ * @param rhall Указатель для RHALL
+ * @return Маска IMU_CHANNEL_* датчиков, получивших новые данные (0 — срок не подошел)
+ * 
+ * Вызывайте как можно чаще. Акселерометр и гироскоп читаются в свои сроки,
+ * магнитометр — в свои, и медленный магнитометр не задерживает быстрые каналы:
+ * - BMM150 за BMI160: 8 байт магнитометра добавляются к пакету только в его срок
+ * - BMM150 на основной шине: читается результат предыдущего Forced Mode
+ *   и запускается следующий, без ожидания измерения (данные отстают
+ *   на один период магнитометра)
+ * 
+ * Массивы датчиков без новых данных не изменяются; время обновления
+ * каждого датчика — IMU_getSampleTimes().
+ * 
+ * @code
+ * IMU_setPollRates(1600, 0);
+ * void loop() {
+ *     uint8_t fresh = IMU_pollSensors(acc, gyr, mag, &rhall);
+ *     if (fresh & IMU_CHANNEL_GYR) { ... }
+ *     if (fresh & IMU_CHANNEL_MAG) { ... }
+ * }
+ * @endcode
+ */
+uint8_t IMU_pollSensors(int16_t *acc, int16_t *gyr, int16_t *mag, int16_t *rhall);
+
+/**
+ * @brief Считывает выбранные каналы без копирования в массивы
+ * 
+ * @param channels Маска IMU_CHANNEL_* (как у IMU_readChannels)
+ * @return Отсчет в буфере драйвера; в updated — каналы, прочитанные этим вызовом
+ * 
+ * Пакет читается прямо в буфер драйвера и не разбирается: оси, которые
+ * нужны, разбираются функциями IMU_viewAcc() и т.д. Указатель всегда один
+ * и тот же, а содержимое меняет любое следующее чтение (IMU_readData,
+ * IMU_pollSensors и др.); значения, которые нужно сохранить, копируйте.
+ * 
+ * @code
+ * const IMU_SampleView* v = IMU_readView(IMU_CHANNEL_GYR);
+ * if (v->updated & IMU_CHANNEL_GYR) {
+ *     yaw_rate = IMU_viewGyr(v, 2) / GYR_LSB;
+ * }
+ * @endcode
+ */
+const IMU_SampleView* IMU_readView(uint8_t channels);
+
+/**
+ * @brief IMU_pollSensors() без копирования в массивы
+ * 
+ * @return Отсчет в буфере драйвера; в updated — датчики, у которых подошел
+ *         срок (0 — ни у одного). Байты остальных датчиков — с их прошлого чтения
+ */
+const IMU_SampleView* IMU_pollSensorsView();
+
+struct IMU_SchedStats;
+
+/**
+ * @brief Статистика сроков опроса акселерометра и гироскопа
+ *        IMU_readDataWithFrequency()
+ * 
+ * @param st Фактическая частота, пропущенные сроки, процентили запаздывания
+ *           (структура объявлена в IMU_Sched.h)
+ * 
+ * @note Статистика начинается заново при смене частоты
+ */
+void IMU_getFrequencyStats(IMU_SchedStats* st);
+
+/**
+ * @brief Статистика сроков опроса акселерометра и гироскопа IMU_pollSensors()
+ * 
+ * @param st Как у IMU_getFrequencyStats()
+ */
+void IMU_getPollStats(IMU_SchedStats* st);
+
+#if IMU_FEATURE_SECONDARY
+// Наибольшее время ожидания ручной операции вторичного интерфейса (мкс)
+#ifndef IMU_AUX_TIMEOUT_US
+#define IMU_AUX_TIMEOUT_US 2000
+#endif
+
+/**
+ * @brief Читает регистры BMM150, подключенного через вторичный интерфейс BMI160
+ * 
+ * @param reg Первый регистр BMM150
+ * @param buf Буфер для данных
+ * @param len Количество байт; блок читается пакетами до 8 байт
+ * @return false если магнитометр не в режиме SECONDARY или обмен не удался
+ * 
+ * Пример — область калибровочных коэффициентов BMM150:
+ * @code
+ * uint8_t trim[21];
+ * IMU_auxRead(0x5D, trim, 21);
+ * @endcode
+ * 
+ * @note На время обмена интерфейс переходит в ручной режим, затем
+ *       возвращается в режим данных
+ */
+bool IMU_auxRead(uint8_t reg, uint8_t* buf, uint8_t len);
+
+/**
+ * @brief Записывает регистры BMM150, подключенного через вторичный интерфейс BMI160
+ * 
+ * @param reg Первый регистр BMM150
+ * @param data Данные
+ * @param len Количество байт (по одной операции интерфейса на байт)
+ * @return false если магнитометр не в режиме SECONDARY или обмен не удался
+ */
+bool IMU_auxWrite(uint8_t reg, const uint8_t* data, uint8_t len);
+#endif
+
+/**
+ * @brief Подменяет шину, через которую драйвер обращается к датчикам
+ * 
+ * @param bus Реализация шины или nullptr для возврата к Wire
+ * 
+ * @note Вызывайте до IMU_begin(): драйвер не переносит состояние между шинами
+ */
+void IMU_setBus(const IMU_Bus* bus);
+
+/**
+ * @brief Устанавливает обработчик транзакций шины
+ * 
+ * @param hook Функция, вызываемая после каждой транзакции, или nullptr для отключения
+ * 
+ * Используется для записи трафика (см. IMU_Capture.h) и диагностики.
+ * Обработчик вызывается синхронно, поэтому должен быть быстрым.
+ */
+void IMU_setBusHook(IMU_BusHook hook);
+
+/**
+ * @brief Включает проверку записей конфигурации чтением при инициализации
+ * 
+ * @param enable true — после записи регистров конфигурации (ACC_CONF..GYR_RANGE,
+ *               MAG_CONF и т.п.) они читаются и сравниваются с записанным
+ * 
+ * По умолчанию выключено: проверка удваивает количество транзакций инициализации.
+ */
+void IMU_setInitVerify(bool enable);
+
+/**
+ * @brief Возвращает счетчики обмена по шине
+ * 
+ * @param stats Структура для счетчиков
+ * 
+ * Разность счетчиков за интервал показывает трафик в установившемся режиме
+ * и экономию от теневых копий регистров.
+ */
+void IMU_getBusStats(IMU_BusStats* stats);
+
+/**
+ * @brief Обнуляет счетчики обмена по шине
+ */
+void IMU_resetBusStats();
+
+/**
+ * @brief Включает или выключает теневые копии регистров конфигурации
+ * 
+ * @param enable true (по умолчанию) — запись неизменившегося значения пропускается,
+ *               чтение конфигурации обслуживается из ОЗУ
+ * 
+ * Кэшируются регистры конфигурации BMI160 (0x40-0x4F, кроме MAG_IF_2/MAG_IF_3,
+ * запись которых запускает обмен с BMM150) и BMM150 при прямом подключении
+ * (0x4B-0x52, кроме OPMODE). Soft Reset сбрасывает копию устройства.
+ * 
+ * @note При IMU_FEATURE_SHADOW = 0 копии не собираются и функции
+ *       IMU_setShadowEnabled(), IMU_setShadowScrub() ничего не делают
+ */
+void IMU_setShadowEnabled(bool enable);
+
+/**
+ * @brief Сбрасывает теневые копии всех устройств
+ * 
+ * Вызывайте, если регистры датчика могли измениться в обход драйвера
+ */
+void IMU_invalidateShadow();
+
+/**
+ * @brief Задает период сверки теневых копий с устройствами
+ * 
+ * @param interval_ms Период в мс или 0 (по умолчанию) для отключения
+ * 
+ * При сверке окно регистров читается одной транзакцией, отличающиеся от копии
+ * регистры перезаписываются (IMU_BusStats::scrub_repairs). Сверка выполняется
+ * внутри IMU_readData().
+ */
+void IMU_setShadowScrub(uint32_t interval_ms);
+
+/**
+ * @brief Читает регистр BMI160 (конфигурация — из теневой копии)
+ */
+bool IMU_readRegister(uint8_t reg, uint8_t* value);
+
+/**
+ * @brief Записывает регистр BMI160 (запись того же значения пропускается)
+ */
+bool IMU_writeRegister(uint8_t reg, uint8_t value);
+
+/**
+ * @brief Изменяет битовое поле регистра BMI160 (чтение-изменение-запись)
+ * 
+ * @param reg Регистр
+ * @param mask Маска изменяемых бит
+ * @param value Новое значение бит (в позиции маски)
+ */
+bool IMU_writeRegisterBits(uint8_t reg, uint8_t mask, uint8_t value);
+
 #endif // IMU_BMI160_BMM150_H
\ No newline at end of file
@@ -0,0 +1,251 @@
+/**
+ * @file IMU_Capture.cpp
+ * @brief Реализация записи и воспроизведения трафика шины IMU
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Capture.h"
+
+// === ЗАПИСЬ ===
+static Print* capture_out = nullptr;
+static uint32_t capture_prev_t = 0;
+static uint32_t capture_bytes = 0;
+static uint32_t capture_dropped = 0;
+
+/**
+ * @brief Определяет, сопровождается ли запись транзакции байтами данных
+ */
+static bool record_has_data(uint8_t op, bool ok) {
+    return op == IMU_BUS_WRITE || (op == IMU_BUS_READ && ok);
+}
+
+// Наибольший размер заголовка записи: 4 байта и приращение времени (до 5 байт)
+#define RECORD_HEADER_MAX (4 + 5)
+
+/**
+ * @brief Кодирует заголовок записи (без байт данных)
+ * 
+ * @return Количество байт, записанных в out (не больше RECORD_HEADER_MAX)
+ */
+static size_t encode_header(const IMU_BusEvent* ev, uint32_t prev_t_us, uint8_t* out) {
+    size_t n = 0;
+    out[n++] = (uint8_t)((ev->op & 0x03) | (ev->ok ? 0x80 : 0x00));
+    out[n++] = ev->addr;
+    out[n++] = ev->reg;
+    out[n++] = ev->len;
+
+    // Приращение времени в формате LEB128: 1 байт до 127 мкс, 2 байта до 16 мс
+    uint32_t dt = ev->t_us - prev_t_us;
+    while (dt >= 0x80) {
+        out[n++] = (uint8_t)(dt | 0x80);
+        dt >>= 7;
+    }
+    out[n++] = (uint8_t)dt;
+    return n;
+}
+
+size_t IMU_captureEncode(const IMU_BusEvent* ev, uint32_t prev_t_us, uint8_t* out) {
+    size_t n = encode_header(ev, prev_t_us, out);
+    if (record_has_data(ev->op, ev->ok) && ev->data) {
+        memcpy(&out[n], ev->data, ev->len);
+        n += ev->len;
+    }
+    return n;
+}
+
+/**
+ * @brief Обработчик транзакций шины: кодирует транзакцию и пишет ее в поток
+ * 
+ * Заголовок и байты данных пишутся в поток по отдельности, прямо из буфера
+ * транзакции: на стеке только заголовок, а не запись целиком (до 264 байт)
+ */
+static void capture_hook(const IMU_BusEvent* ev) {
+    uint8_t head[RECORD_HEADER_MAX];
+    size_t n = encode_header(ev, capture_prev_t, head);
+    capture_prev_t = ev->t_us;
+
+    size_t written = capture_out->write(head, n);
+    if (record_has_data(ev->op, ev->ok) && ev->data && ev->len) {
+        n += ev->len;
+        written += capture_out->write(ev->data, ev->len);
+    }
+    capture_bytes += written;
+    if (written != n) {
+        capture_dropped++;
+    }
+}
+
+bool IMU_captureBegin(Print& out) {
+    const uint8_t header[IMU_CAPTURE_HEADER_SIZE] = {
+        'I', 'M', 'U', 'C', IMU_CAPTURE_VERSION, 0, 0, 0
+    };
+    if (out.write(header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    // Первая запись хранит абсолютное время, последующие — приращения
+    capture_out = &out;
+    capture_prev_t = 0;
+    capture_bytes = sizeof(header);
+    capture_dropped = 0;
+
+    IMU_setBusHook(capture_hook);
+    return true;
+}
+
+void IMU_captureEnd() {
+    IMU_setBusHook(nullptr);
+    capture_out = nullptr;
+}
+
+uint32_t IMU_captureBytes() {
+    return capture_bytes;
+}
+
+uint32_t IMU_captureDropped() {
+    return capture_dropped;
+}
+
+// === РАЗБОР ===
+
+bool IMU_captureReaderInit(IMU_CaptureReader* r, const uint8_t* data, size_t len) {
+    r->data = data;
+    r->len = len;
+    r->pos = IMU_CAPTURE_HEADER_SIZE;
+    r->t_us = 0;
+
+    if (len < IMU_CAPTURE_HEADER_SIZE) {
+        return false;
+    }
+    return data[0] == 'I' && data[1] == 'M' && data[2] == 'U' && data[3] == 'C' &&
+           data[4] == IMU_CAPTURE_VERSION;
+}
+
+bool IMU_captureNext(IMU_CaptureReader* r, IMU_BusEvent* ev) {
+    const uint8_t* p = r->data;
+    size_t pos = r->pos;
+    if (pos + 5 > r->len) {
+        return false;
+    }
+
+    uint8_t flags = p[pos++];
+    ev->op = flags & 0x03;
+    ev->ok = (flags & 0x80) != 0;
+    ev->addr = p[pos++];
+    ev->reg = p[pos++];
+    ev->len = p[pos++];
+
+    uint32_t dt = 0;
+    for (uint8_t shift = 0; ; shift += 7) {
+        if (pos >= r->len || shift > 28) {
+            return false;
+        }
+        uint8_t b = p[pos++];
+        dt |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+    ev->t_us = r->t_us + dt;
+
+    ev->data = nullptr;
+    if (record_has_data(ev->op, ev->ok)) {
+        if (pos + ev->len > r->len) {
+            return false;
+        }
+        ev->data = &p[pos];
+        pos += ev->len;
+    }
+
+    r->pos = pos;
+    r->t_us = ev->t_us;
+    return true;
+}
+
+// === ВОСПРОИЗВЕДЕНИЕ ===
+static IMU_CaptureReader replay_reader;
+static bool replay_done = true;
+static bool replay_underrun = false;
+static uint32_t replay_mismatches = 0;
+static void (*replay_clock_sync)(uint32_t t_us) = nullptr;
+
+/**
+ * @brief Выдает следующую транзакцию записи и проверяет ее соответствие запросу драйвера
+ * 
+ * @return true если запись найдена и совпадает по типу, адресу, регистру и длине
+ */
+static bool replay_next(uint8_t op, uint8_t addr, uint8_t reg, uint8_t len, IMU_BusEvent* ev) {
+    if (!IMU_captureNext(&replay_reader, ev)) {
+        replay_done = true;
+        replay_underrun = true;
+        return false;
+    }
+
+    if (replay_clock_sync) {
+        replay_clock_sync(ev->t_us);
+    }
+
+    if (ev->op != op || ev->addr != addr || ev->reg != reg || ev->len != len) {
+        replay_mismatches++;
+        return false;
+    }
+    return true;
+}
+
+static bool replay_probe(uint8_t addr, uint8_t reg) {
+    IMU_BusEvent ev;
+    if (!replay_next(IMU_BUS_PROBE, addr, reg, 0, &ev)) {
+        return false;
+    }
+    return ev.ok;
+}
+
+static bool replay_write(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len) {
+    IMU_BusEvent ev;
+    if (!replay_next(IMU_BUS_WRITE, addr, reg, len, &ev)) {
+        return false;
+    }
+    if (memcmp(ev.data, data, len) != 0) {
+        replay_mismatches++;
+    }
+    return ev.ok;
+}
+
+static bool replay_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
+    IMU_BusEvent ev;
+    if (!replay_next(IMU_BUS_READ, addr, reg, len, &ev)) {
+        return false;
+    }
+    if (ev.ok) {
+        memcpy(buf, ev.data, len);
+    }
+    return ev.ok;
+}
+
+static const IMU_Bus replay_bus = { replay_probe, replay_write, replay_read };
+
+bool IMU_replayBegin(const uint8_t* data, size_t len, void (*clock_sync)(uint32_t t_us)) {
+    replay_mismatches = 0;
+    replay_underrun = false;
+    replay_clock_sync = clock_sync;
+    replay_done = !IMU_captureReaderInit(&replay_reader, data, len);
+    return !replay_done;
+}
+
+const IMU_Bus* IMU_replayBus() {
+    return &replay_bus;
+}
+
+bool IMU_replayDone() {
+    return replay_done || replay_reader.pos >= replay_reader.len;
+}
+
+uint32_t IMU_replayMismatches() {
+    return replay_mismatches;
+}
+
+bool IMU_replayUnderrun() {
+    return replay_underrun;
+}
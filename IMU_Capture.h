@@ -0,0 +1,153 @@
+/**
+ * @file IMU_Capture.h
+ * @brief Запись и воспроизведение трафика шины IMU
+ * 
+ * Модуль позволяет:
+ * - Записывать каждую транзакцию драйвера (проверка, запись, чтение) с меткой
+ *   времени в компактный двоичный поток (SD-карта, Serial и любой другой Print)
+ * - Разбирать записанный поток
+ * - Воспроизводить запись как шину IMU_Bus: тот же код драйвера получает те же
+ *   байты, что и на реальном устройстве, в том числе на Linux-хосте
+ * 
+ * Формат потока:
+ * - Заголовок 8 байт: 'I' 'M' 'U' 'C', версия (1), 3 резервных байта
+ * - Записи транзакций:
+ *   * байт 0: биты 0-1 — IMU_BusOp, бит 7 — успешность транзакции
+ *   * байт 1: адрес устройства
+ *   * байт 2: начальный регистр
+ *   * байт 3: длина данных
+ *   * varint (LEB128): приращение времени в мкс относительно предыдущей записи
+ *   * данные: len байт для записи и успешного чтения, иначе отсутствуют
+ * 
+ * Типичная запись одного пакета BMI160 (20 байт) занимает 25-26 байт.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_CAPTURE_H
+#define IMU_CAPTURE_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Размер заголовка потока записи (байт)
+#define IMU_CAPTURE_HEADER_SIZE 8
+
+// Версия формата потока записи
+#define IMU_CAPTURE_VERSION 1
+
+// Максимальный размер одной закодированной записи (байт)
+#define IMU_CAPTURE_MAX_RECORD (4 + 5 + 255)
+
+/**
+ * @brief Начинает запись трафика шины в поток
+ * 
+ * @param out Поток для записи (например, открытый файл SD или Serial)
+ * @return true если заголовок успешно записан
+ * 
+ * Записывает заголовок и устанавливает обработчик транзакций через IMU_setBusHook().
+ * 
+ * @note Запись выполняется синхронно внутри транзакции, поэтому медленный поток
+ *       увеличивает время цикла опроса
+ */
+bool IMU_captureBegin(Print& out);
+
+/**
+ * @brief Останавливает запись и снимает обработчик транзакций
+ */
+void IMU_captureEnd();
+
+/**
+ * @brief Возвращает количество байт, записанных с момента IMU_captureBegin()
+ */
+uint32_t IMU_captureBytes();
+
+/**
+ * @brief Возвращает количество записей, которые не удалось записать в поток полностью
+ */
+uint32_t IMU_captureDropped();
+
+/**
+ * @brief Кодирует одну транзакцию в формат потока
+ * 
+ * @param ev Описание транзакции
+ * @param prev_t_us Время предыдущей записи (мкс)
+ * @param out Буфер не меньше IMU_CAPTURE_MAX_RECORD байт
+ * @return Количество байт, записанных в out
+ */
+size_t IMU_captureEncode(const IMU_BusEvent* ev, uint32_t prev_t_us, uint8_t* out);
+
+// Состояние разбора записанного потока
+struct IMU_CaptureReader {
+    const uint8_t* data;  // Начало потока (включая заголовок)
+    size_t len;           // Длина потока
+    size_t pos;           // Текущая позиция разбора
+    uint32_t t_us;        // Время последней разобранной записи
+};
+
+/**
+ * @brief Подготавливает разбор записанного потока
+ * 
+ * @param r Состояние разбора
+ * @param data Поток (включая заголовок)
+ * @param len Длина потока
+ * @return true если заголовок корректен
+ */
+bool IMU_captureReaderInit(IMU_CaptureReader* r, const uint8_t* data, size_t len);
+
+/**
+ * @brief Разбирает следующую запись потока
+ * 
+ * @param r Состояние разбора
+ * @param ev Описание транзакции; ev->data указывает внутрь потока
+ * @return false если поток закончился или последняя запись обрезана
+ */
+bool IMU_captureNext(IMU_CaptureReader* r, IMU_BusEvent* ev);
+
+/**
+ * @brief Подготавливает воспроизведение записи
+ * 
+ * @param data Записанный поток (должен оставаться доступным до конца воспроизведения)
+ * @param len Длина потока
+ * @param clock_sync Функция установки времени (мкс) перед каждой транзакцией или nullptr
+ * @return true если заголовок корректен
+ * 
+ * После вызова подключите шину IMU_replayBus() через IMU_setBus() и вызывайте
+ * функции драйвера в том же порядке, что и при записи. Каждая транзакция
+ * драйвера сопоставляется со следующей записью потока: чтение получает
+ * записанные байты, запись и проверка — записанный результат.
+ * 
+ * Через clock_sync время хоста выставляется по меткам записи, поэтому
+ * логика драйвера, зависящая от millis()/micros(), повторяется точно.
+ */
+bool IMU_replayBegin(const uint8_t* data, size_t len, void (*clock_sync)(uint32_t t_us));
+
+/**
+ * @brief Возвращает шину, воспроизводящую запись
+ */
+const IMU_Bus* IMU_replayBus();
+
+/**
+ * @brief Проверяет, закончились ли записи для воспроизведения
+ */
+bool IMU_replayDone();
+
+/**
+ * @brief Проверяет, запрашивал ли драйвер транзакции после конца записи
+ * 
+ * Обычно означает, что запись оборвалась посреди последнего чтения данных
+ * и его результат нужно отбросить.
+ */
+bool IMU_replayUnderrun();
+
+/**
+ * @brief Возвращает количество расхождений между драйвером и записью
+ * 
+ * Расхождение — транзакция драйвера, не совпадающая с записью по типу, адресу,
+ * регистру, длине или записываемым байтам. Ненулевое значение означает, что
+ * код драйвера ведет себя не так, как при записи.
+ */
+uint32_t IMU_replayMismatches();
+
+#endif // IMU_CAPTURE_H
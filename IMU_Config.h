@@ -0,0 +1,161 @@
+/**
+ * @file IMU_Config.h
+ * @brief Конфигурация акселерометра и гироскопа, заданная на этапе компиляции
+ * 
+ * Шаблон Imu<> фиксирует диапазоны и частоты датчиков в типе:
+ * - значения регистров, коэффициенты преобразования и частоты — constexpr
+ * - недопустимые сочетания отвергаются static_assert
+ * - преобразование в физические единицы сводится к умножению на константу,
+ *   без чтения глобальных ACC_LSB/GYR_LSB и деления
+ * 
+ * Пример:
+ * @code
+ * typedef Imu<AccRange::G4, GyrRange::Dps2000, Odr::Hz400, Odr::Hz400> MyImu;
+ * 
+ * MyImu::begin();
+ * IMU_readData(acc_raw, gyr_raw, mag_raw, &rhall_raw);
+ * float ax = MyImu::accToG(acc_raw[0]);
+ * @endcode
+ * 
+ * Обычный API (IMU_setAccelRange, ACC_LSB и т.д.) остается доступным.
+ * Не меняйте диапазоны через него, если используете Imu<>: константы
+ * шаблона не узнают об изменении.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_CONFIG_H
+#define IMU_CONFIG_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Диапазоны акселерометра (значения регистра ACC_RANGE)
+enum class AccRange : uint8_t {
+    G2  = 0x03, // ±2g (16384 LSB/g)
+    G4  = 0x05, // ±4g (8192 LSB/g)
+    G8  = 0x08, // ±8g (4096 LSB/g)
+    G16 = 0x0C  // ±16g (2048 LSB/g)
+};
+
+// Диапазоны гироскопа (значения регистра GYR_RANGE)
+enum class GyrRange : uint8_t {
+    Dps2000 = 0x00, // ±2000°/s (16.384 LSB/°/s)
+    Dps1000 = 0x01, // ±1000°/s (32.768 LSB/°/s)
+    Dps500  = 0x02, // ±500°/s (65.536 LSB/°/s)
+    Dps250  = 0x03, // ±250°/s (131.072 LSB/°/s)
+    Dps125  = 0x04  // ±125°/s (262.144 LSB/°/s)
+};
+
+// Выходная частота данных (поле odr регистров ACC_CONF/GYR_CONF)
+enum class Odr : uint8_t {
+    Hz25   = 0x06,
+    Hz50   = 0x07,
+    Hz100  = 0x08,
+    Hz200  = 0x09,
+    Hz400  = 0x0A,
+    Hz800  = 0x0B,
+    Hz1600 = 0x0C, // Максимум для акселерометра
+    Hz3200 = 0x0D  // Только для гироскопа
+};
+
+namespace imu_config {
+
+// Чувствительность акселерометра (LSB/g)
+constexpr float acc_lsb(AccRange r) {
+    return r == AccRange::G2 ? 16384.0f :
+           r == AccRange::G4 ? 8192.0f :
+           r == AccRange::G8 ? 4096.0f : 2048.0f;
+}
+
+// Чувствительность гироскопа (LSB/°/s): 16.384 * 2^код
+constexpr float gyr_lsb(GyrRange r) {
+    return 16.384f * (float)(1u << (uint8_t)r);
+}
+
+// Частота по коду ODR (Гц): 25 * 2^(код - 6)
+constexpr float odr_hz(Odr o) {
+    return 25.0f * (float)(1u << ((uint8_t)o - 0x06));
+}
+
+// Значение регистра ACC_CONF/GYR_CONF: нормальный режим фильтра (bwp = 2) и ODR
+constexpr uint8_t conf_reg(Odr o) {
+    return (uint8_t)(0x20 | (uint8_t)o);
+}
+
+} // namespace imu_config
+
+/**
+ * @brief Конфигурация IMU, известная на этапе компиляции
+ * 
+ * @tparam AR Диапазон акселерометра
+ * @tparam GR Диапазон гироскопа
+ * @tparam AO Частота акселерометра (до 1600 Гц)
+ * @tparam GO Частота гироскопа (до 3200 Гц)
+ */
+template <AccRange AR, GyrRange GR, Odr AO = Odr::Hz100, Odr GO = Odr::Hz100>
+struct Imu {
+    static_assert(AO <= Odr::Hz1600, "BMI160: частота акселерометра не выше 1600 Гц");
+    static_assert(GO <= Odr::Hz3200, "BMI160: частота гироскопа не выше 3200 Гц");
+    static_assert(AR == AccRange::G2 || AR == AccRange::G4 || AR == AccRange::G8 || AR == AccRange::G16,
+                  "BMI160: недопустимый код диапазона акселерометра");
+    static_assert(GR <= GyrRange::Dps125, "BMI160: недопустимый код диапазона гироскопа");
+
+    // Значения регистров
+    static constexpr uint8_t acc_conf = imu_config::conf_reg(AO);
+    static constexpr uint8_t acc_range = (uint8_t)AR;
+    static constexpr uint8_t gyr_conf = imu_config::conf_reg(GO);
+    static constexpr uint8_t gyr_range = (uint8_t)GR;
+
+    // Коэффициенты преобразования (обратные величины чувствительности)
+    static constexpr float acc_g_per_lsb = 1.0f / imu_config::acc_lsb(AR);
+    static constexpr float gyr_dps_per_lsb = 1.0f / imu_config::gyr_lsb(GR);
+
+    // Частоты (Гц)
+    static constexpr float acc_odr_hz = imu_config::odr_hz(AO);
+    static constexpr float gyr_odr_hz = imu_config::odr_hz(GO);
+
+    /**
+     * @brief Возвращает конфигурацию в виде SensorConfig для обычного API
+     */
+    static SensorConfig config() {
+        SensorConfig cfg = { acc_conf, acc_range, gyr_conf, gyr_range };
+        return cfg;
+    }
+
+    /**
+     * @brief Применяет конфигурацию и инициализирует IMU
+     * 
+     * @return Результат IMU_begin()
+     */
+    static bool begin() {
+        IMU_setConfig(config());
+        return IMU_begin();
+    }
+
+    /**
+     * @brief Применяет конфигурацию к уже инициализированной IMU
+     */
+    static void apply() {
+        IMU_setConfig(config());
+    }
+
+    // Преобразование в физические единицы (умножение на константу)
+    static float accToG(int16_t raw) { return raw * acc_g_per_lsb; }
+    static float gyrToDps(int16_t raw) { return raw * gyr_dps_per_lsb; }
+
+    static void accToG(const int16_t* raw, float* g) {
+        g[0] = raw[0] * acc_g_per_lsb;
+        g[1] = raw[1] * acc_g_per_lsb;
+        g[2] = raw[2] * acc_g_per_lsb;
+    }
+
+    static void gyrToDps(const int16_t* raw, float* dps) {
+        dps[0] = raw[0] * gyr_dps_per_lsb;
+        dps[1] = raw[1] * gyr_dps_per_lsb;
+        dps[2] = raw[2] * gyr_dps_per_lsb;
+    }
+};
+
+#endif // IMU_CONFIG_H
@@ -0,0 +1,79 @@
+/**
+ * @file IMU_Features.h
+ * @brief Выбор возможностей драйвера на этапе сборки
+ *
+ * Каждая возможность включена по умолчанию (значение 1). Выключенная
+ * возможность не компилируется: ее код и статические данные не попадают
+ * во flash и ОЗУ. Для малых плат (ATmega328P, 2 КБ ОЗУ) удобнее всего
+ * задать IMU_PROFILE_MINIMAL — остается только поиск BMI160 и BMM150
+ * на основной шине по адресам 0x10–0x13 и чтение данных.
+ *
+ * Arduino IDE компилирует библиотеку отдельно от скетча, поэтому #define
+ * в скетче сюда не доходит. Значения задаются одним из способов:
+ * - правкой этого файла (раздел «Настройка проекта» ниже)
+ * - флагами компилятора: arduino-cli compile
+ *   --build-property "compiler.cpp.extra_flags=-DIMU_PROFILE_MINIMAL"
+ *   или build_flags в PlatformIO
+ *
+ * Вклад каждой возможности во flash и ОЗУ показывает extras/size/imu_size.sh.
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_FEATURES_H
+#define IMU_FEATURES_H
+
+// === НАСТРОЙКА ПРОЕКТА ===
+// #define IMU_PROFILE_MINIMAL
+// #define IMU_BMI160_BMM150_DEBUG
+
+#ifdef IMU_PROFILE_MINIMAL
+#ifndef IMU_FEATURE_SECONDARY
+#define IMU_FEATURE_SECONDARY 0
+#endif
+#ifndef IMU_FEATURE_FULL_SCAN
+#define IMU_FEATURE_FULL_SCAN 0
+#endif
+#ifndef IMU_FEATURE_AUTORANGE
+#define IMU_FEATURE_AUTORANGE 0
+#endif
+#ifndef IMU_FEATURE_SHADOW
+#define IMU_FEATURE_SHADOW 0
+#endif
+#ifndef IMU_FEATURE_SERIAL_BEGIN
+#define IMU_FEATURE_SERIAL_BEGIN 0
+#endif
+#endif
+
+// BMM150 за вторичным интерфейсом BMI160: поиск в IMU_begin(),
+// режим SECONDARY, IMU_auxRead() и IMU_auxWrite()
+#ifndef IMU_FEATURE_SECONDARY
+#define IMU_FEATURE_SECONDARY 1
+#endif
+
+// Поиск BMM150 перебором всех адресов 0x00–0x7F, если он не найден
+// по штатным адресам (128 транзакций при каждом IMU_begin() без магнитометра)
+#ifndef IMU_FEATURE_FULL_SCAN
+#define IMU_FEATURE_FULL_SCAN 1
+#endif
+
+// Автоматический выбор диапазона (IMU_setAutoRange)
+#ifndef IMU_FEATURE_AUTORANGE
+#define IMU_FEATURE_AUTORANGE 1
+#endif
+
+// Теневые копии регистров конфигурации (IMU_setShadowEnabled, IMU_setShadowScrub).
+// Без них каждая запись и чтение конфигурации идет на шину
+#ifndef IMU_FEATURE_SHADOW
+#define IMU_FEATURE_SHADOW 1
+#endif
+
+// IMU_begin() вызывает Serial.begin(115200). Без этого HardwareSerial
+// и его буферы (~160 байт ОЗУ на AVR) не подключаются, если скетч сам
+// не использует Serial; скетч с Serial вызывает Serial.begin() сам
+#ifndef IMU_FEATURE_SERIAL_BEGIN
+#define IMU_FEATURE_SERIAL_BEGIN 1
+#endif
+
+#endif // IMU_FEATURES_H
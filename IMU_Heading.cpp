@@ -0,0 +1,184 @@
+/**
+ * @file IMU_Heading.cpp
+ * @brief Реализация курса с компенсацией наклона в фиксированной точке (CORDIC)
+ * 
+ * Углы внутри — 32-битные двоичные (2^32 = полный оборот), переполнение
+ * соответствует переходу через ±180°.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Heading.h"
+
+#if IMU_HEADING_ITERATIONS < 10 || IMU_HEADING_ITERATIONS > 16
+#error "IMU_HEADING_ITERATIONS должно быть в пределах 10..16"
+#endif
+
+// atan(2^-i) в двоичных единицах угла
+static const uint32_t cordic_atan[16] PROGMEM = {
+    0x20000000UL, 0x12E4051EUL, 0x09FB385BUL, 0x051111D4UL,
+    0x028B0D43UL, 0x0145D7E1UL, 0x00A2F61EUL, 0x00517C55UL,
+    0x0028BE53UL, 0x00145F2FUL, 0x000A2F98UL, 0x000517CCUL,
+    0x00028BE6UL, 0x000145F3UL, 0x0000A2FAUL, 0x0000517DUL,
+};
+
+// 1/K — обратный коэффициент усиления CORDIC (Q15)
+static const int32_t CORDIC_INV_GAIN_Q15 = 19898;
+
+// Нормировка: наибольшая компонента попадает в [2^25, 2^26) — младшие разряды
+// не теряются на сдвигах CORDIC, а после двух поворотов (усиление K² ≈ 2.7)
+// длина вектора остается в int32
+static const uint8_t NORM_BITS = 26;
+
+/**
+ * @brief Сдвигает вектор так, чтобы наибольшая компонента была в [2^(NORM_BITS-1), 2^NORM_BITS)
+ * 
+ * Малые векторы сдвигаются влево, большие (до INT32_MIN) — вправо.
+ */
+static void normalize(int32_t* v) {
+    uint32_t m = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        // Модуль в uint32_t: -INT32_MIN в int32_t не представим
+        uint32_t a = v[i] < 0 ? 0UL - (uint32_t)v[i] : (uint32_t)v[i];
+        if (a > m) m = a;
+    }
+    if (m == 0) {
+        return;
+    }
+    uint8_t shift = 0;
+    if (m >= (1UL << NORM_BITS)) {
+        while ((m >> shift) >= (1UL << NORM_BITS)) shift++;
+        for (uint8_t i = 0; i < 3; i++) {
+            v[i] >>= shift;
+        }
+        return;
+    }
+    while ((m << shift) < (1UL << (NORM_BITS - 1))) shift++;
+    for (uint8_t i = 0; i < 3; i++) {
+        v[i] = v[i] * (1L << shift);
+    }
+}
+
+/**
+ * @brief v / K без 64-битного умножения
+ */
+static int32_t mul_inv_gain(int32_t v) {
+    int32_t hi = v >> 15;
+    int32_t lo = v & 0x7FFF;
+    return hi * CORDIC_INV_GAIN_Q15 + ((lo * CORDIC_INV_GAIN_Q15) >> 15);
+}
+
+/**
+ * @brief CORDIC, векторный режим: поворачивает (x, y) на ось X
+ * 
+ * @param x, y Вектор (на выходе x = K·|v|, y ≈ 0)
+ * @return Угол вектора (двоичные единицы)
+ */
+static uint32_t cordic_vector(int32_t* px, int32_t* py) {
+    int32_t x = *px, y = *py;
+    uint32_t z = 0;
+    if (x < 0) {
+        // Перевод в правую полуплоскость поворотом на 180°
+        x = -x;
+        y = -y;
+        z = 0x80000000UL;
+    }
+    for (uint8_t i = 0; i < IMU_HEADING_ITERATIONS; i++) {
+        int32_t xs = x >> i, ys = y >> i;
+        uint32_t a = pgm_read_dword(&cordic_atan[i]);
+        if (y > 0) {
+            x += ys;
+            y -= xs;
+            z += a;
+        } else {
+            x -= ys;
+            y += xs;
+            z -= a;
+        }
+    }
+    *px = x;
+    *py = y;
+    return z;
+}
+
+/**
+ * @brief CORDIC, режим поворота: поворачивает (x, y) на угол a (результат умножен на K)
+ */
+static void cordic_rotate(int32_t* px, int32_t* py, uint32_t a) {
+    int32_t x = *px, y = *py;
+    int32_t z = (int32_t)a;
+    if (z > 0x40000000L || z < -0x40000000L) {
+        x = -x;
+        y = -y;
+        z = (int32_t)(a + 0x80000000UL);
+    }
+    for (uint8_t i = 0; i < IMU_HEADING_ITERATIONS; i++) {
+        int32_t xs = x >> i, ys = y >> i;
+        int32_t t = (int32_t)pgm_read_dword(&cordic_atan[i]);
+        if (z >= 0) {
+            x -= ys;
+            y += xs;
+            z -= t;
+        } else {
+            x += ys;
+            y -= xs;
+            z += t;
+        }
+    }
+    *px = x;
+    *py = y;
+}
+
+/**
+ * @brief Двоичный угол (2^32 = оборот) в сотые доли градуса со знаком
+ */
+static int32_t angle_to_cdeg(uint32_t a) {
+    int32_t h = (int32_t)a >> 16;  // 65536 = оборот
+    return (h * 36000L + (h >= 0 ? 32768L : -32768L)) / 65536L;
+}
+
+int16_t IMU_atan2Fixed(int32_t y, int32_t x) {
+    int32_t v[3] = { x, y, 0 };
+    normalize(v);
+    return (int16_t)(cordic_vector(&v[0], &v[1]) >> 16);
+}
+
+bool IMU_computeHeading(const int16_t* acc, const int16_t* mag, IMU_Heading* out) {
+    int32_t a[3] = { acc[0], acc[1], acc[2] };
+    int32_t m[3] = { mag[0], mag[1], mag[2] };
+    if ((a[0] | a[1] | a[2]) == 0 || (m[0] | m[1] | m[2]) == 0) {
+        return false;
+    }
+    normalize(a);
+    normalize(m);
+
+    // Крен и длина проекции на плоскость YZ: r = K·sqrt(ay² + az²) = K·(ay·sinφ + az·cosφ)
+    int32_t ry = a[2], rz = a[1];
+    uint32_t roll = cordic_vector(&ry, &rz);
+    int32_t r = mul_inv_gain(ry);
+
+    // Тангаж
+    int32_t px = r, py = -a[0];
+    uint32_t pitch = cordic_vector(&px, &py);
+
+    // Поворот (my, mz) на φ: By = my·cosφ - mz·sinφ, Mz' = my·sinφ + mz·cosφ (оба ×K)
+    int32_t by = m[1], mz = m[2];
+    cordic_rotate(&by, &mz, roll);
+    mz = mul_inv_gain(mz);
+
+    // Поворот (mx, Mz') на -θ: Bx = mx·cosθ + Mz'·sinθ (×K, как и By)
+    int32_t bx = m[0], bz = mz;
+    cordic_rotate(&bx, &bz, (uint32_t)0 - pitch);
+
+    int32_t hx = bx, hy = -by;
+    uint32_t heading = cordic_vector(&hx, &hy);
+
+    int32_t h = angle_to_cdeg(heading);
+    if (h < 0) h += 36000;
+    if (h >= 36000) h -= 36000;
+    out->heading_cdeg = (uint16_t)h;
+    out->pitch_cdeg = (int16_t)angle_to_cdeg(pitch);
+    out->roll_cdeg = (int16_t)angle_to_cdeg(roll);
+    return true;
+}
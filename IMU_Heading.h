@@ -0,0 +1,65 @@
+/**
+ * @file IMU_Heading.h
+ * @brief Курс с компенсацией наклона, тангаж и крен в фиксированной точке
+ * 
+ * Для контроллеров без FPU (Arduino Uno/Nano): вычисление по сырым
+ * массивам acc и mag без float, atan2 и sqrt. Используется CORDIC:
+ * - векторный режим — atan2 и длина вектора одновременно
+ * - режим поворота — проекция вектора магнитного поля на горизонт
+ * Перед вычислением векторы нормируются сдвигом (целочисленная нормировка),
+ * чтобы использовать полную разрядность независимо от диапазона датчика.
+ * 
+ * Формулы (оси магнитометра совпадают с осями акселерометра):
+ *   крен   φ = atan2(ay, az)
+ *   тангаж θ = atan2(-ax, ay·sinφ + az·cosφ)
+ *   By = my·cosφ - mz·sinφ
+ *   Bx = mx·cosθ + (my·sinφ + mz·cosφ)·sinθ
+ *   курс   ψ = atan2(-By, Bx), 0..360°
+ * 
+ * Погрешность алгоритма относительно вычисления в double на тех же
+ * целочисленных входах (измерено в extras/bench/heading_bench.cpp):
+ * - IMU_HEADING_ITERATIONS = 16: не более 0.02° по каждому углу
+ * - IMU_HEADING_ITERATIONS = 12: не более 0.16°
+ * Вблизи тангажа ±90° крен и курс не определены. На практике точность
+ * курса ограничивает дискретность магнитометра и калибровка, а не алгоритм.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_HEADING_H
+#define IMU_HEADING_H
+
+#include <Arduino.h>
+
+// Число итераций CORDIC (разрешение ~ atan(2^-(N-1)); 10..16)
+#ifndef IMU_HEADING_ITERATIONS
+#define IMU_HEADING_ITERATIONS 16
+#endif
+
+// Углы в сотых долях градуса
+struct IMU_Heading {
+    uint16_t heading_cdeg;  // Курс 0..35999
+    int16_t pitch_cdeg;     // Тангаж -9000..9000
+    int16_t roll_cdeg;      // Крен -18000..18000
+};
+
+/**
+ * @brief Вычисляет курс, тангаж и крен по сырым данным
+ * 
+ * @param acc Акселерометр (LSB, любой диапазон)
+ * @param mag Магнитометр (LSB, после компенсации смещения)
+ * @param out Результат
+ * @return false если вектор ускорения или поля нулевой
+ */
+bool IMU_computeHeading(const int16_t* acc, const int16_t* mag, IMU_Heading* out);
+
+/**
+ * @brief atan2 в фиксированной точке (CORDIC)
+ * 
+ * @param y, x Компоненты вектора: весь диапазон int32_t, включая INT32_MIN
+ * @return Угол в двоичных единицах: 65536 = полный оборот, ±32768 = ±180°
+ */
+int16_t IMU_atan2Fixed(int32_t y, int32_t x);
+
+#endif // IMU_HEADING_H
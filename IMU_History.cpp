@@ -0,0 +1,279 @@
+/**
+ * @file IMU_History.cpp
+ * @brief Реализация истории отсчетов с заморозкой окна вокруг события
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_History.h"
+
+// Запись не идет ни в один банк
+#define HIST_NO_BANK 2
+
+// Формат выгрузки — байты отсчета как есть
+static_assert(sizeof(IMU_HistSample) == 22, "IMU_HistSample: 22 байта без выравнивания");
+
+static void bank_reset(IMU_HistBank* b) {
+    b->start = 0;
+    b->count = 0;
+    b->trigger_pos = 0;
+    b->exported = 0;
+    b->state = IMU_HIST_RECORDING;
+}
+
+bool IMU_historyInit(IMU_History* h, IMU_HistSample* buf, uint16_t capacity, uint16_t post) {
+    if (capacity < 2 || post >= capacity) {
+        return false;
+    }
+    memset(h, 0, sizeof(*h));
+    h->capacity = capacity;
+    h->post = post;
+    h->bank[0].buf = buf;
+    h->bank[1].buf = buf + capacity;
+    bank_reset(&h->bank[0]);
+    h->bank[1].state = IMU_HIST_FREE;
+    h->active = 0;
+    h->thr_ranges = 0xFF;
+    return true;
+}
+
+void IMU_historySetThreshold(IMU_History* h, float acc_g, float gyr_dps) {
+    h->thr_acc_g = acc_g;
+    h->thr_gyr_dps = gyr_dps;
+    h->thr_ranges = 0xFF;
+}
+
+void IMU_historyTrigger(IMU_History* h) {
+    h->trigger_request = 1;
+}
+
+static float acc_lsb_per_g(uint8_t range) {
+    switch (range) {
+        case 0x05: return 8192.0f;
+        case 0x08: return 4096.0f;
+        case 0x0C: return 2048.0f;
+        default: return 16384.0f;
+    }
+}
+
+static float gyr_lsb_per_dps(uint8_t range) {
+    switch (range) {
+        case 0x00: return 16.384f;
+        case 0x01: return 32.768f;
+        case 0x02: return 65.536f;
+        case 0x04: return 262.144f;
+        default: return 131.072f;
+    }
+}
+
+// Порог в LSB (0 — выключен; выше шкалы — 32767, срабатывает на насыщении)
+static uint16_t threshold_lsb(float value, float lsb) {
+    if (value <= 0) {
+        return 0;
+    }
+    float t = value * lsb;
+    return t >= 32767.0f ? 32767 : (uint16_t)(t + 0.5f);
+}
+
+static uint16_t peak_abs(const int16_t* v) {
+    uint16_t peak = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        uint16_t a = v[i] < 0 ? (uint16_t)(-(int32_t)v[i]) : (uint16_t)v[i];
+        if (a > peak) {
+            peak = a;
+        }
+    }
+    return peak;
+}
+
+/**
+ * @brief Проверяет порог; пороги в LSB пересчитываются только при смене диапазона
+ */
+static bool threshold_hit(IMU_History* h, const IMU_HistSample* r) {
+    if (h->thr_acc_g <= 0 && h->thr_gyr_dps <= 0) {
+        return false;
+    }
+    if (r->ranges != h->thr_ranges) {
+        h->thr_ranges = r->ranges;
+        h->thr_acc_lsb = threshold_lsb(h->thr_acc_g, acc_lsb_per_g(r->ranges & 0x0F));
+        h->thr_gyr_lsb = threshold_lsb(h->thr_gyr_dps, gyr_lsb_per_dps(r->ranges >> 4));
+    }
+    return (h->thr_acc_lsb && peak_abs(r->acc) >= h->thr_acc_lsb) ||
+           (h->thr_gyr_lsb && peak_abs(r->gyr) >= h->thr_gyr_lsb);
+}
+
+/**
+ * @brief Замораживает банк записи и переключает запись на свободный банк
+ */
+static void freeze_active(IMU_History* h) {
+    IMU_HistBank* b = &h->bank[h->active];
+    b->state = IMU_HIST_FROZEN;
+    b->seq = h->frozen++;
+    uint8_t other = h->active ^ 1;
+    if (h->bank[other].state == IMU_HIST_FREE) {
+        bank_reset(&h->bank[other]);
+        h->active = other;
+    } else {
+        h->active = HIST_NO_BANK;
+    }
+}
+
+bool IMU_historyPush(IMU_History* h, const IMU_Sample* s, uint8_t acc_range, uint8_t gyr_range) {
+    uint8_t trigger = h->trigger_request;
+    if (h->active == HIST_NO_BANK) {
+        h->dropped++;
+        if (trigger) {
+            h->trigger_request = 0;
+            h->missed++;
+        }
+        return false;
+    }
+    IMU_HistBank* b = &h->bank[h->active];
+
+    // Кольцо: при заполнении новый отсчет занимает место самого старого
+    uint16_t pos;
+    if (b->count < h->capacity) {
+        pos = b->start + b->count;
+        if (pos >= h->capacity) {
+            pos -= h->capacity;
+        }
+        if (b->count == 0) {
+            b->t_first_us = s->t_us;
+        }
+        b->count++;
+    } else {
+        pos = b->start;
+        b->start = (uint16_t)(pos + 1 == h->capacity ? 0 : pos + 1);
+        b->t_first_us += b->buf[b->start].dt_us;
+        if (b->state == IMU_HIST_POST) {
+            b->trigger_pos--;
+        }
+    }
+
+    IMU_HistSample* r = &b->buf[pos];
+    uint32_t dt = b->count == 1 ? 0 : s->t_us - h->t_last_us;
+    h->t_last_us = s->t_us;
+    r->dt_us = dt > 0xFFFF ? 0xFFFF : (uint16_t)dt;
+    r->flags = dt > 0xFFFF ? IMU_HIST_FLAG_GAP : 0;
+    r->ranges = (uint8_t)((acc_range & 0x0F) | (gyr_range << 4));
+    memcpy(r->acc, s->acc, sizeof(r->acc));
+    memcpy(r->gyr, s->gyr, sizeof(r->gyr));
+    memcpy(r->mag, s->mag, sizeof(r->mag));
+
+    if (b->state == IMU_HIST_RECORDING) {
+        if (trigger || threshold_hit(h, r)) {
+            h->trigger_request = 0;
+            r->flags |= IMU_HIST_FLAG_TRIGGER;
+            b->state = IMU_HIST_POST;
+            b->cause = trigger ? IMU_HIST_CAUSE_API : IMU_HIST_CAUSE_THRESHOLD;
+            b->trigger_pos = (uint16_t)(b->count - 1);
+            b->t_trigger_us = s->t_us;
+            h->post_left = h->post;
+            if (h->post_left == 0) {
+                freeze_active(h);
+            }
+        }
+    } else if (--h->post_left == 0) {
+        // Событие во время окна после события входит в то же окно
+        h->trigger_request = 0;
+        freeze_active(h);
+    }
+    return true;
+}
+
+bool IMU_historySample(IMU_History* h) {
+    IMU_Sample s;
+    uint8_t acc_range, gyr_range;
+    IMU_readData(s.acc, s.gyr, s.mag, &s.rhall);
+    s.t_us = micros();
+    IMU_getSampleRanges(&acc_range, &gyr_range);
+    return IMU_historyPush(h, &s, acc_range, gyr_range);
+}
+
+/**
+ * @brief Банк, который выгружается следующим (заморожен раньше других), или nullptr
+ */
+static IMU_HistBank* export_bank(const IMU_History* h) {
+    const IMU_HistBank* a = &h->bank[0];
+    const IMU_HistBank* b = &h->bank[1];
+    bool fa = a->state == IMU_HIST_FROZEN;
+    bool fb = b->state == IMU_HIST_FROZEN;
+    if (fa && fb) {
+        return (IMU_HistBank*)((int32_t)(a->seq - b->seq) < 0 ? a : b);
+    }
+    return (IMU_HistBank*)(fa ? a : fb ? b : nullptr);
+}
+
+bool IMU_historyReady(const IMU_History* h) {
+    return export_bank(h) != nullptr;
+}
+
+bool IMU_historySnapshot(const IMU_History* h, IMU_HistSnapshot* info) {
+    const IMU_HistBank* b = export_bank(h);
+    if (!b) {
+        return false;
+    }
+    info->t_first_us = b->t_first_us;
+    info->t_trigger_us = b->t_trigger_us;
+    info->count = b->count;
+    info->trigger_index = b->trigger_pos;
+    info->cause = b->cause;
+    return true;
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+size_t IMU_historyExport(IMU_History* h, Print& out, uint16_t max_samples) {
+    IMU_HistBank* b = export_bank(h);
+    if (!b) {
+        return 0;
+    }
+    size_t written = 0;
+    if (b->exported == 0) {
+        uint8_t head[IMU_HISTORY_HEADER_SIZE] = { 'I', 'M', 'U', 'H', IMU_HISTORY_VERSION,
+                                                  (uint8_t)sizeof(IMU_HistSample), b->cause, 0 };
+        put32(&head[8], b->t_first_us);
+        put32(&head[12], b->t_trigger_us);
+        put16(&head[16], b->count);
+        put16(&head[18], b->trigger_pos);
+        put32(&head[20], h->dropped);
+        written += out.write(head, sizeof(head));
+    }
+
+    // Не больше двух непрерывных блоков: до конца буфера и с его начала
+    uint16_t left = b->count - b->exported;
+    if (left > max_samples) {
+        left = max_samples;
+    }
+    while (left) {
+        uint16_t pos = b->start + b->exported;
+        if (pos >= h->capacity) {
+            pos -= h->capacity;
+        }
+        uint16_t run = h->capacity - pos;
+        if (run > left) {
+            run = left;
+        }
+        written += out.write((const uint8_t*)&b->buf[pos], (size_t)run * sizeof(IMU_HistSample));
+        b->exported += run;
+        left -= run;
+    }
+
+    if (b->exported == b->count) {
+        b->state = IMU_HIST_FREE;
+        if (h->active == HIST_NO_BANK) {
+            bank_reset(b);
+            h->active = (uint8_t)(b - h->bank);
+        }
+    }
+    return written;
+}
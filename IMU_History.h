@@ -0,0 +1,205 @@
+/**
+ * @file IMU_History.h
+ * @brief Непрерывная история отсчетов и выгрузка окна вокруг события
+ *
+ * История постоянно пишется в кольцо компактных отсчетов (IMU_HistSample,
+ * 22 байта). Событие — превышение порога, флаг из прерывания или вызов
+ * IMU_historyTrigger() — замораживает окно: отсчеты до события, которые
+ * уже есть в кольце, и post отсчетов после него. Запись при этом
+ * продолжается во второй банк, а замороженное окно выгружается в любой
+ * Print (файл SD, Serial) частями по IMU_historyExport(), не останавливая
+ * опрос датчика.
+ *
+ * Память: 2 · capacity отсчетов, выделяет вызывающий. Длительность окна
+ * до события — (capacity - 1 - post) отсчетов; IMU_HISTORY_SAMPLES()
+ * переводит секунды в отсчеты.
+ *
+ * Формат выгрузки (little-endian):
+ * - Заголовок IMU_HISTORY_HEADER_SIZE байт: 'I' 'M' 'U' 'H', версия (1),
+ *   размер отсчета (uint8), причина (uint8), резерв (uint8),
+ *   t_first_us (uint32), t_trigger_us (uint32), count (uint16),
+ *   trigger_index (uint16), dropped (uint32, всего не записано отсчетов)
+ * - count отсчетов IMU_HistSample в порядке записи
+ * Время отсчета k: t_first_us + сумма dt_us отсчетов 1..k.
+ *
+ * Пример:
+ * @code
+ * IMU_HistSample hist_buf[2 * 256];
+ * IMU_History hist;
+ * IMU_historyInit(&hist, hist_buf, 256, 64);     // 191 до события, 64 после
+ * IMU_historySetThreshold(&hist, 6.0f, 0);       // удар: любая ось >= 6 g
+ *
+ * void loop() {
+ *     if (IMU_schedDue(&sched)) {
+ *         IMU_historySample(&hist);
+ *     }
+ *     if (IMU_historyReady(&hist)) {
+ *         IMU_historyExport(&hist, file, 32);    // 704 байта за вызов
+ *     }
+ * }
+ * @endcode
+ *
+ * @note IMU_historyPush()/IMU_historySample() и IMU_historyExport()
+ *       вызываются из одного контекста; из прерывания — только IMU_historyTrigger()
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_HISTORY_H
+#define IMU_HISTORY_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Размер заголовка выгрузки (байт)
+#define IMU_HISTORY_HEADER_SIZE 24
+
+// Версия формата выгрузки
+#define IMU_HISTORY_VERSION 1
+
+// Отсчетов в банке для окна seconds при частоте rate_hz
+#define IMU_HISTORY_SAMPLES(rate_hz, seconds) ((uint16_t)((rate_hz) * (seconds)) + 1)
+
+// Флаги отсчета
+#define IMU_HIST_FLAG_TRIGGER 0x01  // Отсчет, на котором сработало событие
+#define IMU_HIST_FLAG_GAP     0x02  // Интервал больше 65535 мкс (dt_us насыщен)
+
+// Причина заморозки окна
+enum IMU_HistCause : uint8_t {
+    IMU_HIST_CAUSE_API = 1,         // IMU_historyTrigger() (в том числе из прерывания)
+    IMU_HIST_CAUSE_THRESHOLD = 2    // Порог IMU_historySetThreshold()
+};
+
+// Компактный отсчет истории (22 байта, без выравнивания внутри)
+struct IMU_HistSample {
+    uint16_t dt_us;         // Интервал от предыдущего отсчета (мкс, насыщение 65535)
+    uint8_t ranges;         // Диапазоны: биты 3:0 — ACC_RANGE, биты 7:4 — GYR_RANGE
+    uint8_t flags;          // IMU_HIST_FLAG_*
+    int16_t acc[3];
+    int16_t gyr[3];
+    int16_t mag[3];
+};
+
+// Состояние банка
+enum IMU_HistBankState : uint8_t {
+    IMU_HIST_FREE = 0,      // Свободен
+    IMU_HIST_RECORDING,     // Идет запись, событий не было
+    IMU_HIST_POST,          // Событие было, пишутся отсчеты после него
+    IMU_HIST_FROZEN         // Окно заморожено и ждет выгрузки
+};
+
+struct IMU_HistBank {
+    IMU_HistSample* buf;
+    uint16_t start;         // Индекс самого старого отсчета
+    uint16_t count;         // Отсчетов в кольце
+    uint16_t trigger_pos;   // Смещение отсчета-события от start
+    uint16_t exported;      // Выгружено отсчетов
+    uint32_t t_first_us;    // Время самого старого отсчета
+    uint32_t t_trigger_us;
+    uint32_t seq;           // Порядковый номер заморозки (выгружается старший первым)
+    uint8_t state;          // IMU_HistBankState
+    uint8_t cause;          // IMU_HistCause
+};
+
+struct IMU_History {
+    IMU_HistBank bank[2];
+    uint16_t capacity;      // Отсчетов в банке
+    uint16_t post;          // Отсчетов после события
+    uint16_t post_left;
+    uint8_t active;         // Банк записи; 2 — оба банка заморожены, запись стоит
+    volatile uint8_t trigger_request;
+    uint32_t t_last_us;     // Время последнего записанного отсчета
+    uint32_t frozen;        // Заморожено окон
+    uint32_t dropped;       // Отсчетов не записано: оба банка ждут выгрузки
+    uint32_t missed;        // Событий пропущено по той же причине
+    float thr_acc_g;        // Порог акселерометра (g), 0 — выключен
+    float thr_gyr_dps;      // Порог гироскопа (°/s), 0 — выключен
+    uint8_t thr_ranges;     // Диапазоны, для которых посчитаны пороги в LSB
+    uint16_t thr_acc_lsb;
+    uint16_t thr_gyr_lsb;
+};
+
+// Сводка замороженного окна
+struct IMU_HistSnapshot {
+    uint32_t t_first_us;
+    uint32_t t_trigger_us;
+    uint16_t count;
+    uint16_t trigger_index; // Позиция отсчета-события в окне
+    uint8_t cause;          // IMU_HistCause
+};
+
+/**
+ * @brief Инициализирует историю
+ *
+ * @param h История
+ * @param buf Буфер на 2 · capacity отсчетов (два банка)
+ * @param capacity Отсчетов в банке (2..65535)
+ * @param post Отсчетов после события (меньше capacity)
+ * @return false если параметры недопустимы
+ */
+bool IMU_historyInit(IMU_History* h, IMU_HistSample* buf, uint16_t capacity, uint16_t post);
+
+/**
+ * @brief Задает порог события по модулю любой оси
+ *
+ * @param acc_g Порог акселерометра (g) или 0
+ * @param gyr_dps Порог гироскопа (°/s) или 0
+ *
+ * Порог переводится в LSB по диапазону каждого отсчета, поэтому
+ * автоматический выбор диапазона его не смещает. Насыщенная ось
+ * (±32767) превышает любой порог выше шкалы.
+ */
+void IMU_historySetThreshold(IMU_History* h, float acc_g, float gyr_dps);
+
+/**
+ * @brief Запрашивает событие: окно замораживается на следующем отсчете
+ *
+ * Можно вызывать из обработчика прерывания (внешний датчик удара,
+ * прерывание any-motion BMI160).
+ */
+void IMU_historyTrigger(IMU_History* h);
+
+/**
+ * @brief Добавляет отсчет
+ *
+ * @param s Отсчет
+ * @param acc_range Код диапазона акселерометра отсчета (IMU_getSampleRanges)
+ * @param gyr_range Код диапазона гироскопа отсчета
+ * @return false если отсчет не записан (оба банка ждут выгрузки)
+ */
+bool IMU_historyPush(IMU_History* h, const IMU_Sample* s, uint8_t acc_range, uint8_t gyr_range);
+
+/**
+ * @brief Читает датчик (IMU_readData с меткой micros()) и добавляет отсчет
+ *
+ * @return false если отсчет не записан
+ */
+bool IMU_historySample(IMU_History* h);
+
+/**
+ * @brief Проверяет, есть ли замороженное окно для выгрузки
+ */
+bool IMU_historyReady(const IMU_History* h);
+
+/**
+ * @brief Сводка окна, которое выгружается следующим
+ *
+ * @return false если замороженных окон нет
+ */
+bool IMU_historySnapshot(const IMU_History* h, IMU_HistSnapshot* info);
+
+/**
+ * @brief Выгружает следующую часть замороженного окна
+ *
+ * @param out Поток (файл SD, Serial и т.п.)
+ * @param max_samples Наибольшее число отсчетов за вызов
+ * @return Записано байт (0 — выгружать нечего)
+ *
+ * Первый вызов для окна пишет заголовок. Отсчеты пишутся одним или двумя
+ * блоками (кольцо) через Print::write(buf, len). После последнего отсчета
+ * банк освобождается и, если запись стояла, она продолжается в нем.
+ */
+size_t IMU_historyExport(IMU_History* h, Print& out, uint16_t max_samples);
+
+#endif // IMU_HISTORY_H
@@ -0,0 +1,280 @@
+/**
+ * @file IMU_LogCodec.cpp
+ * @brief Реализация сжатого блочного формата журнала отсчетов IMU
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_LogCodec.h"
+
+// Время кодирования: на МК — micros() (в такты переводится по F_CPU),
+// на x86-хосте без F_CPU — счетчик тактов TSC (micros() хоста — виртуальные часы)
+#if !defined(F_CPU) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define IMU_LOG_CLOCK_TSC 1
+#endif
+
+// === ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ ===
+
+static inline uint32_t encode_clock() {
+#ifdef IMU_LOG_CLOCK_TSC
+    return (uint32_t)__rdtsc();
+#else
+    return micros();
+#endif
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Раскладывает отсчет в массив из 10 каналов (acc, gyr, mag, rhall)
+ */
+static void sample_to_channels(const IMU_Sample* s, int16_t* ch) {
+    ch[0] = s->acc[0]; ch[1] = s->acc[1]; ch[2] = s->acc[2];
+    ch[3] = s->gyr[0]; ch[4] = s->gyr[1]; ch[5] = s->gyr[2];
+    ch[6] = s->mag[0]; ch[7] = s->mag[1]; ch[8] = s->mag[2];
+    ch[9] = s->rhall;
+}
+
+static void channels_to_sample(const int16_t* ch, IMU_Sample* s) {
+    s->acc[0] = ch[0]; s->acc[1] = ch[1]; s->acc[2] = ch[2];
+    s->gyr[0] = ch[3]; s->gyr[1] = ch[4]; s->gyr[2] = ch[5];
+    s->mag[0] = ch[6]; s->mag[1] = ch[7]; s->mag[2] = ch[8];
+    s->rhall = ch[9];
+}
+
+/**
+ * @brief Записывает число со знаком в формате zigzag + varint
+ * 
+ * @return Количество записанных байт (1-5)
+ */
+static uint8_t put_svarint(uint8_t* p, int32_t v) {
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+    uint8_t n = 0;
+    while (z >= 0x80) {
+        p[n++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+/**
+ * @brief Читает число в формате zigzag + varint
+ * 
+ * @return Количество прочитанных байт или 0, если число выходит за пределы буфера
+ */
+static uint8_t get_svarint(const uint8_t* p, const uint8_t* end, int32_t* v) {
+    uint32_t z = 0;
+    uint8_t n = 0;
+    for (uint8_t shift = 0; shift <= 28; shift += 7) {
+        if (p + n >= end) {
+            return 0;
+        }
+        uint8_t b = p[n++];
+        z |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+            return n;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Начинает новый блок с опорным отсчетом s
+ */
+static void block_start(IMU_LogEncoder* enc, const IMU_Sample* s) {
+    uint8_t* b = enc->block;
+    b[0] = 'I';
+    b[1] = 'L';
+    b[2] = IMU_LOG_VERSION;
+    put_u32(&b[6], enc->seq);
+    put_u32(&b[10], s->t_us);
+    b[14] = 0;
+    b[15] = 0;
+
+    int16_t ch[10];
+    sample_to_channels(s, ch);
+    for (uint8_t i = 0; i < 10; i++) {
+        put_u16(&b[16 + 2 * i], (uint16_t)ch[i]);
+    }
+
+    enc->used = IMU_LOG_HEADER_SIZE;
+    enc->count = 1;
+    enc->prev_dt = 0;
+}
+
+/**
+ * @brief Дописывает текущий блок нулями и выводит его в поток
+ */
+static void block_emit(IMU_LogEncoder* enc) {
+    uint8_t* b = enc->block;
+    b[3] = enc->count;
+    put_u16(&b[4], enc->used);
+    memset(&b[enc->used], 0, enc->block_size - enc->used);
+
+    size_t written = enc->out->write(b, enc->block_size);
+    if (written != enc->block_size) {
+        enc->write_errors++;
+    }
+    enc->out_bytes += written;
+    enc->payload_bytes += enc->used;
+    enc->blocks++;
+    enc->seq++;
+    enc->count = 0;
+    enc->used = 0;
+}
+
+// === КОДИРОВАНИЕ ===
+
+bool IMU_logEncoderInit(IMU_LogEncoder* enc, Print& out, uint8_t* block, uint16_t block_size) {
+    memset(enc, 0, sizeof(*enc));
+    enc->out = &out;
+    enc->block = block;
+    enc->block_size = block_size;
+    return block_size >= IMU_LOG_HEADER_SIZE + IMU_LOG_MAX_SAMPLE_SIZE;
+}
+
+void IMU_logAppend(IMU_LogEncoder* enc, const IMU_Sample* s) {
+    uint32_t start = encode_clock();
+
+    if (enc->count == 0) {
+        block_start(enc, s);
+    } else {
+        uint8_t tmp[IMU_LOG_MAX_SAMPLE_SIZE];
+        uint8_t n = 0;
+
+        uint32_t dt = s->t_us - enc->prev.t_us;
+        n += put_svarint(&tmp[n], (int32_t)(dt - enc->prev_dt));
+
+        int16_t cur[10], prev[10];
+        sample_to_channels(s, cur);
+        sample_to_channels(&enc->prev, prev);
+        for (uint8_t i = 0; i < 10; i++) {
+            n += put_svarint(&tmp[n], (int32_t)cur[i] - (int32_t)prev[i]);
+        }
+
+        if (enc->count == IMU_LOG_MAX_SAMPLES || enc->used + n > enc->block_size) {
+            block_emit(enc);
+            block_start(enc, s);
+        } else {
+            memcpy(&enc->block[enc->used], tmp, n);
+            enc->used += n;
+            enc->count++;
+            enc->prev_dt = dt;
+        }
+    }
+
+    enc->prev = *s;
+    enc->samples++;
+    enc->encode_time += encode_clock() - start;
+}
+
+void IMU_logFlush(IMU_LogEncoder* enc) {
+    if (enc->count > 0) {
+        block_emit(enc);
+    }
+}
+
+float IMU_logCompressionRatio(const IMU_LogEncoder* enc) {
+    uint32_t payload = enc->payload_bytes + enc->used;
+    if (payload == 0) {
+        return 0.0f;
+    }
+    return (float)enc->samples * IMU_LOG_RAW_SAMPLE_SIZE / (float)payload;
+}
+
+uint32_t IMU_logCyclesPerSample(const IMU_LogEncoder* enc) {
+    if (enc->samples == 0) {
+        return 0;
+    }
+#if defined(IMU_LOG_CLOCK_TSC)
+    return enc->encode_time / enc->samples;
+#elif defined(F_CPU)
+    const uint32_t cycles_per_us = F_CPU / 1000000UL;
+    return (uint32_t)((uint64_t)enc->encode_time * cycles_per_us / enc->samples);
+#else
+    return 0; // Ни F_CPU, ни счетчика тактов: такты не определить
+#endif
+}
+
+// === ДЕКОДИРОВАНИЕ ===
+
+bool IMU_logBlockInfo(const uint8_t* block, uint16_t block_size, IMU_LogBlockInfo* info) {
+    if (block_size < IMU_LOG_HEADER_SIZE || block[0] != 'I' || block[1] != 'L' ||
+        block[2] != IMU_LOG_VERSION) {
+        return false;
+    }
+    info->count = block[3];
+    info->used = get_u16(&block[4]);
+    info->seq = get_u32(&block[6]);
+    info->t0_us = get_u32(&block[10]);
+    return info->count > 0 && info->used >= IMU_LOG_HEADER_SIZE && info->used <= block_size;
+}
+
+int IMU_logDecodeBlock(const uint8_t* block, uint16_t block_size, IMU_Sample* out, int max_samples) {
+    IMU_LogBlockInfo info;
+    if (!IMU_logBlockInfo(block, block_size, &info)) {
+        return -1;
+    }
+
+    int16_t ch[10];
+    for (uint8_t i = 0; i < 10; i++) {
+        ch[i] = (int16_t)get_u16(&block[16 + 2 * i]);
+    }
+    uint32_t t = info.t0_us;
+    uint32_t dt = 0;
+
+    const uint8_t* p = &block[IMU_LOG_HEADER_SIZE];
+    const uint8_t* end = &block[info.used];
+    int n = 0;
+    for (;;) {
+        if (n < max_samples) {
+            out[n].t_us = t;
+            channels_to_sample(ch, &out[n]);
+        }
+        n++;
+        if (n == info.count) {
+            break;
+        }
+
+        int32_t v;
+        uint8_t k = get_svarint(p, end, &v);
+        if (!k) {
+            return -1;
+        }
+        p += k;
+        dt += (uint32_t)v;
+        t += dt;
+
+        for (uint8_t i = 0; i < 10; i++) {
+            k = get_svarint(p, end, &v);
+            if (!k) {
+                return -1;
+            }
+            p += k;
+            ch[i] = (int16_t)(ch[i] + v);
+        }
+    }
+    return n < max_samples ? n : max_samples;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file IMU_LogCodec.h
+ * @brief Сжатый блочный формат журнала отсчетов IMU
+ * 
+ * Журнал состоит из блоков фиксированного размера (обычно 512 байт — сектор SD).
+ * Каждый блок начинается с заголовка и опорного отсчета без сжатия, поэтому
+ * блок декодируется независимо от остальных: к N-му блоку файла можно перейти
+ * по смещению N * block_size, а по заголовкам — искать нужное время.
+ * 
+ * Заголовок блока (IMU_LOG_HEADER_SIZE = 36 байт, little-endian):
+ * - 0-1:   'I' 'L'
+ * - 2:     версия формата
+ * - 3:     количество отсчетов в блоке (включая опорный)
+ * - 4-5:   количество занятых байт блока (включая заголовок)
+ * - 6-9:   порядковый номер блока
+ * - 10-13: время опорного отсчета (мкс)
+ * - 14-15: резерв
+ * - 16-35: опорный отсчет: acc[3], gyr[3], mag[3], rhall (int16)
+ * 
+ * Каждый следующий отсчет кодируется как 11 чисел в формате zigzag + varint:
+ * - изменение интервала времени относительно предыдущего интервала
+ *   (при постоянной частоте опроса — 0, т.е. 1 байт)
+ * - разность каждого из 10 каналов с предыдущим отсчетом
+ * 
+ * Остаток блока после последнего отсчета заполняется нулями.
+ * 
+ * При медленном изменении сигнала отсчет занимает 11-16 байт вместо 24
+ * несжатых, худший случай — 35 байт.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_LOG_CODEC_H
+#define IMU_LOG_CODEC_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Версия формата блока
+#define IMU_LOG_VERSION 1
+
+// Размер заголовка блока с опорным отсчетом (байт)
+#define IMU_LOG_HEADER_SIZE 36
+
+// Размер несжатого отсчета: время + 10 каналов (байт)
+#define IMU_LOG_RAW_SAMPLE_SIZE 24
+
+// Максимальный размер закодированного отсчета (байт)
+#define IMU_LOG_MAX_SAMPLE_SIZE 35
+
+// Максимальное количество отсчетов в блоке
+#define IMU_LOG_MAX_SAMPLES 255
+
+// Состояние потокового кодировщика
+struct IMU_LogEncoder {
+    Print* out;             // Поток для готовых блоков
+    uint8_t* block;         // Буфер текущего блока (предоставляется вызывающим)
+    uint16_t block_size;    // Размер блока
+    uint16_t used;          // Занято байт в текущем блоке
+    uint8_t count;          // Отсчетов в текущем блоке
+    uint32_t seq;           // Номер текущего блока
+    IMU_Sample prev;        // Предыдущий отсчет
+    uint32_t prev_dt;       // Предыдущий интервал времени (мкс)
+
+    // Статистика
+    uint32_t samples;       // Закодировано отсчетов
+    uint32_t blocks;        // Записано блоков
+    uint32_t out_bytes;     // Записано байт (полные блоки)
+    uint32_t payload_bytes; // Полезных байт в записанных блоках
+    uint32_t encode_time;   // Суммарное время кодирования (мкс; на x86-хосте — такты TSC)
+    uint32_t write_errors;  // Блоки, записанные в поток не полностью
+};
+
+/**
+ * @brief Инициализирует кодировщик
+ * 
+ * @param enc Состояние кодировщика
+ * @param out Поток для готовых блоков (файл SD, SPI flash и т.п.)
+ * @param block Буфер блока; весь объем ОЗУ кодировщика — этот буфер и структура
+ * @param block_size Размер блока (от IMU_LOG_HEADER_SIZE + IMU_LOG_MAX_SAMPLE_SIZE)
+ * @return false если размер блока слишком мал
+ */
+bool IMU_logEncoderInit(IMU_LogEncoder* enc, Print& out, uint8_t* block, uint16_t block_size);
+
+/**
+ * @brief Добавляет отсчет в журнал
+ * 
+ * @param enc Состояние кодировщика
+ * @param s Отсчет
+ * 
+ * Если отсчет не помещается в текущий блок, блок дописывается нулями,
+ * выводится в поток, и отсчет становится опорным в новом блоке.
+ */
+void IMU_logAppend(IMU_LogEncoder* enc, const IMU_Sample* s);
+
+/**
+ * @brief Выводит незаполненный текущий блок в поток
+ * 
+ * Вызывайте перед закрытием файла, иначе последние отсчеты будут потеряны
+ */
+void IMU_logFlush(IMU_LogEncoder* enc);
+
+/**
+ * @brief Возвращает степень сжатия (несжатый объем / полезный объем блоков)
+ */
+float IMU_logCompressionRatio(const IMU_LogEncoder* enc);
+
+/**
+ * @brief Возвращает среднее количество тактов процессора на кодирование одного отсчета
+ * 
+ * @note На МК рассчитывается по micros() и F_CPU, поэтому на AVR имеет
+ *       погрешность порядка 4 мкс на отсчет при малом количестве отсчетов
+ * @note На x86-хосте (без F_CPU) — по счетчику тактов TSC; на других
+ *       платформах без F_CPU возвращает 0
+ */
+uint32_t IMU_logCyclesPerSample(const IMU_LogEncoder* enc);
+
+// Сведения из заголовка блока
+struct IMU_LogBlockInfo {
+    uint8_t count;      // Отсчетов в блоке
+    uint16_t used;      // Занято байт
+    uint32_t seq;       // Номер блока
+    uint32_t t0_us;     // Время опорного отсчета
+};
+
+/**
+ * @brief Читает заголовок блока без декодирования отсчетов
+ * 
+ * @return false если блок поврежден или не является блоком журнала
+ */
+bool IMU_logBlockInfo(const uint8_t* block, uint16_t block_size, IMU_LogBlockInfo* info);
+
+/**
+ * @brief Декодирует все отсчеты блока
+ * 
+ * @param block Блок журнала
+ * @param block_size Размер блока
+ * @param out Массив для отсчетов (не меньше IMU_LOG_MAX_SAMPLES или info.count)
+ * @param max_samples Размер массива out
+ * @return Количество декодированных отсчетов или -1 при повреждении блока
+ */
+int IMU_logDecodeBlock(const uint8_t* block, uint16_t block_size, IMU_Sample* out, int max_samples);
+
+#endif // IMU_LOG_CODEC_H
@@ -0,0 +1,118 @@
+/**
+ * @file IMU_Preint.cpp
+ * @brief Реализация преинтегрирования с компенсацией конического и гребного движения
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Preint.h"
+
+static const float DEG_TO_RAD_F = 0.017453292519943295f;
+static const float G_MS2 = 9.80665f;
+
+/**
+ * @brief r += ½ a × b
+ */
+static void add_half_cross(float* r, const float* a, const float* b) {
+    r[0] += 0.5f * (a[1] * b[2] - a[2] * b[1]);
+    r[1] += 0.5f * (a[2] * b[0] - a[0] * b[2]);
+    r[2] += 0.5f * (a[0] * b[1] - a[1] * b[0]);
+}
+
+/**
+ * @brief Обнуляет накопители интервала (предыдущие приращения сохраняются)
+ */
+static void reset_interval(IMU_Preint* p) {
+    for (uint8_t i = 0; i < 3; i++) {
+        p->alpha[i] = 0;
+        p->beta[i] = 0;
+        p->upsilon[i] = 0;
+        p->scul[i] = 0;
+    }
+    p->t_start_us = p->t_prev_us;
+    p->span_us = 0;
+    p->samples = 0;
+}
+
+void IMU_preintInit(IMU_Preint* p) {
+    memset(p, 0, sizeof(*p));
+}
+
+void IMU_preintPush(IMU_Preint* p, uint32_t t_us, const int16_t* acc, const int16_t* gyr) {
+    float w[3], a[3];
+    const float kw = DEG_TO_RAD_F / GYR_LSB;
+    const float ka = G_MS2 / ACC_LSB;
+    for (uint8_t i = 0; i < 3; i++) {
+        w[i] = gyr[i] * kw;
+        a[i] = acc[i] * ka;
+    }
+    IMU_preintPushRates(p, t_us, w, a);
+}
+
+void IMU_preintPushRates(IMU_Preint* p, uint32_t t_us, const float* gyr_rad_s, const float* acc_ms2) {
+    uint32_t dt_us = t_us - p->t_prev_us;
+    if (!p->have_prev || dt_us == 0 || dt_us > IMU_PREINT_MAX_GAP_US) {
+        if (p->have_prev && dt_us != 0) {
+            p->gaps++;
+        }
+        // Через разрыв предыдущие приращения не переносятся
+        p->have_prev = true;
+        p->have_increment = false;
+        p->t_prev_us = t_us;
+        if (p->samples == 0) {
+            p->t_start_us = t_us;
+        }
+        return;
+    }
+    p->t_prev_us = t_us;
+
+    float dt = dt_us * 1e-6f;
+    float da[3], dv[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        da[i] = gyr_rad_s[i] * dt;
+        dv[i] = acc_ms2[i] * dt;
+    }
+
+    // Поправки по α, υ до добавления текущего приращения
+    float a1[3], v1[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        a1[i] = p->alpha[i];
+        v1[i] = p->upsilon[i];
+        if (p->have_increment) {
+            a1[i] += p->dalpha_prev[i] * (1.0f / 6.0f);
+            v1[i] += p->dv_prev[i] * (1.0f / 6.0f);
+        }
+    }
+    add_half_cross(p->beta, a1, da);
+    add_half_cross(p->scul, a1, dv);
+    add_half_cross(p->scul, v1, da);
+
+    for (uint8_t i = 0; i < 3; i++) {
+        p->alpha[i] += da[i];
+        p->upsilon[i] += dv[i];
+        p->dalpha_prev[i] = da[i];
+        p->dv_prev[i] = dv[i];
+    }
+    p->have_increment = true;
+    p->span_us += dt_us;
+    p->samples++;
+}
+
+bool IMU_preintPop(IMU_Preint* p, IMU_PreintDelta* out) {
+    if (p->samples == 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        out->dtheta[i] = p->alpha[i] + p->beta[i];
+        out->dvel[i] = p->upsilon[i] + p->scul[i];
+    }
+    // Поправка на вращение: ½ α × υ
+    add_half_cross(out->dvel, p->alpha, p->upsilon);
+    out->t_start_us = p->t_start_us;
+    out->t_end_us = p->t_prev_us;
+    out->dt = p->span_us * 1e-6f;
+    out->samples = p->samples;
+    reset_interval(p);
+    return true;
+}
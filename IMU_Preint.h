@@ -0,0 +1,101 @@
+/**
+ * @file IMU_Preint.h
+ * @brief Преинтегрирование приращений угла и скорости с компенсацией конического и гребного движения
+ * 
+ * Фильтр навигации обычно работает на низкой частоте (например, 100 Гц),
+ * а простое прореживание IMU_readData теряет движение между обновлениями.
+ * Модуль принимает отсчеты гироскопа и акселерометра с полной частотой
+ * датчика и накапливает приращения:
+ * - угла Δθ (вектор поворота, рад) с поправкой на коническое движение (coning)
+ * - скорости Δv (кажущейся, в связанных осях на начало интервала, м/с)
+ *   с поправками на вращение и гребное движение (sculling)
+ * 
+ * Потребитель забирает одно приращение и его интервал с нужной ему частотой.
+ * Используется рекуррентный алгоритм Сэвиджа с одним предыдущим отсчетом
+ * (Savage, "Strapdown Inertial Navigation Integration Algorithm Design", 1998):
+ *   β  += ½ (α + Δα_prev / 6) × Δα
+ *   δv += ½ [(α + Δα_prev / 6) × Δv + (υ + Δv_prev / 6) × Δα]
+ *   Δθ = α + β,  Δv = υ + ½ α × υ + δv
+ * 
+ * Сила тяжести не вычитается — это задача фильтра, знающего ориентацию.
+ * 
+ * @note Вычисления в float: на AVR без FPU годится для частот до ~100 Гц,
+ *       полная частота датчика рассчитана на 32-битные контроллеры.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_PREINT_H
+#define IMU_PREINT_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Наибольший интервал между отсчетами, который интегрируется (мкс);
+// больший разрыв считается потерей данных и начинает отсчет заново
+#ifndef IMU_PREINT_MAX_GAP_US
+#define IMU_PREINT_MAX_GAP_US 100000UL
+#endif
+
+// Приращение за интервал
+struct IMU_PreintDelta {
+    float dtheta[3];        // Вектор поворота за интервал (рад)
+    float dvel[3];          // Приращение кажущейся скорости (м/с)
+    uint32_t t_start_us;    // Время начала интервала
+    uint32_t t_end_us;      // Время последнего отсчета интервала
+    float dt;               // Длительность интервала (с)
+    uint16_t samples;       // Отсчетов в интервале
+};
+
+struct IMU_Preint {
+    float alpha[3];         // Сумма приращений угла Σ Δα
+    float beta[3];          // Коническая поправка
+    float upsilon[3];       // Сумма приращений скорости Σ Δv
+    float scul[3];          // Гребная поправка
+    float dalpha_prev[3];   // Предыдущее приращение угла (в т.ч. из прошлого интервала)
+    float dv_prev[3];       // Предыдущее приращение скорости
+    uint32_t t_prev_us;     // Время предыдущего отсчета
+    uint32_t t_start_us;    // Начало текущего интервала
+    uint32_t span_us;       // Накопленная длительность интервала
+    uint16_t samples;       // Отсчетов в интервале
+    bool have_prev;         // Есть предыдущий отсчет (известна метка времени)
+    bool have_increment;    // Δα_prev / Δv_prev действительны
+    uint32_t gaps;          // Разрывов потока (интервал больше IMU_PREINT_MAX_GAP_US)
+};
+
+/**
+ * @brief Инициализирует преинтегратор
+ */
+void IMU_preintInit(IMU_Preint* p);
+
+/**
+ * @brief Добавляет отсчет в единицах датчика
+ * 
+ * Пересчет по текущим ACC_LSB и GYR_LSB. Приращения за отсчет: скорость,
+ * умноженная на интервал от предыдущего отсчета. Первый отсчет после
+ * инициализации или разрыва только задает метку времени.
+ * 
+ * @param p Преинтегратор
+ * @param t_us Время отсчета (micros() или IMU_getSampleTimes)
+ * @param acc Акселерометр (LSB)
+ * @param gyr Гироскоп (LSB)
+ */
+void IMU_preintPush(IMU_Preint* p, uint32_t t_us, const int16_t* acc, const int16_t* gyr);
+
+/**
+ * @brief Добавляет отсчет в физических единицах
+ * 
+ * @param gyr_rad_s Угловая скорость (рад/с)
+ * @param acc_ms2 Кажущееся ускорение (м/с²)
+ */
+void IMU_preintPushRates(IMU_Preint* p, uint32_t t_us, const float* gyr_rad_s, const float* acc_ms2);
+
+/**
+ * @brief Забирает накопленное приращение и начинает новый интервал
+ * 
+ * @return false если с прошлого вызова не было проинтегрировано ни одного отсчета
+ */
+bool IMU_preintPop(IMU_Preint* p, IMU_PreintDelta* out);
+
+#endif // IMU_PREINT_H
@@ -0,0 +1,182 @@
+/**
+ * @file IMU_PubSub.cpp
+ * @brief Реализация раздачи отсчетов подпискам
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_PubSub.h"
+
+static IMU_Subscriber* subscribers = nullptr;
+
+/**
+ * @brief Наступил ли срок выдачи подписки
+ */
+static bool is_due(const IMU_Subscriber* sub, uint32_t now_us) {
+    return !sub->started || (int32_t)(now_us - sub->next_due_us) >= 0;
+}
+
+/**
+ * @brief Нужен ли подписке с усреднением очередной отсчет в сумму
+ */
+static bool wants_input(const IMU_Subscriber* sub, uint32_t now_us) {
+    return sub->filter == IMU_DECIMATE_MEAN &&
+           (sub->count == 0 || (int32_t)(now_us - sub->next_input_us) >= 0);
+}
+
+/**
+ * @brief Раскладывает каналы отсчета в массив из 10 значений
+ */
+static void sample_values(const IMU_Sample* s, int16_t* v) {
+    for (uint8_t i = 0; i < 3; i++) {
+        v[i] = s->acc[i];
+        v[3 + i] = s->gyr[i];
+        v[6 + i] = s->mag[i];
+    }
+    v[9] = s->rhall;
+}
+
+/**
+ * @brief Обнуляет каналы вне маски
+ */
+static void mask_sample(IMU_Sample* s, uint8_t channels) {
+    if (!(channels & IMU_CHANNEL_ACC)) s->acc[0] = s->acc[1] = s->acc[2] = 0;
+    if (!(channels & IMU_CHANNEL_GYR)) s->gyr[0] = s->gyr[1] = s->gyr[2] = 0;
+    if (!(channels & IMU_CHANNEL_MAG)) {
+        s->mag[0] = s->mag[1] = s->mag[2] = 0;
+        s->rhall = 0;
+    }
+}
+
+/**
+ * @brief Выдает отсчет подписке и назначает следующий срок
+ */
+static void deliver(IMU_Subscriber* sub, const IMU_Sample* s, uint32_t now_us) {
+    IMU_Sample out = *s;
+    if (sub->filter == IMU_DECIMATE_MEAN && sub->count > 1) {
+        int16_t* dst[10] = {
+            &out.acc[0], &out.acc[1], &out.acc[2], &out.gyr[0], &out.gyr[1], &out.gyr[2],
+            &out.mag[0], &out.mag[1], &out.mag[2], &out.rhall
+        };
+        int32_t half = sub->count / 2;
+        for (uint8_t i = 0; i < 10; i++) {
+            // Округление к ближайшему для обоих знаков
+            int32_t v = sub->sum[i];
+            *dst[i] = (int16_t)((v >= 0 ? v + half : v - half) / sub->count);
+        }
+    }
+    mask_sample(&out, sub->channels);
+    sub->count = 0;
+    memset(sub->sum, 0, sizeof(sub->sum));
+
+    if (!sub->started) {
+        sub->started = true;
+        sub->next_due_us = now_us;
+    }
+    sub->next_due_us += sub->period_us;
+    // После долгой паузы не выдавать пропущенные сроки пачкой
+    if ((int32_t)(now_us - sub->next_due_us) >= 0) {
+        sub->next_due_us = now_us + sub->period_us;
+    }
+    sub->delivered++;
+    sub->callback(&out, sub->ctx);
+}
+
+void IMU_subscribe(IMU_Subscriber* sub, uint8_t channels, float rate_hz, uint8_t filter,
+                   IMU_SampleCallback callback, void* ctx) {
+    IMU_unsubscribe(sub);
+    sub->channels = channels & IMU_CHANNEL_ALL;
+    sub->filter = filter;
+    sub->period_us = rate_hz > 0 ? (uint32_t)(1000000.0f / rate_hz + 0.5f) : 0;
+    sub->callback = callback;
+    sub->ctx = ctx;
+    sub->next_due_us = 0;
+    sub->next_input_us = 0;
+    sub->started = false;
+    sub->count = 0;
+    memset(sub->sum, 0, sizeof(sub->sum));
+    sub->delivered = 0;
+    sub->next = subscribers;
+    subscribers = sub;
+}
+
+void IMU_unsubscribe(IMU_Subscriber* sub) {
+    for (IMU_Subscriber** p = &subscribers; *p; p = &(*p)->next) {
+        if (*p == sub) {
+            *p = sub->next;
+            sub->next = nullptr;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Каналы, нужные подпискам; в due — только подпискам с наступившим сроком
+ */
+static uint8_t pending_channels(uint32_t now_us, uint8_t* due) {
+    uint8_t need = 0;
+    *due = 0;
+    for (IMU_Subscriber* sub = subscribers; sub; sub = sub->next) {
+        if (is_due(sub, now_us)) {
+            *due |= sub->channels;
+            need |= sub->channels;
+        } else if (wants_input(sub, now_us)) {
+            need |= sub->channels;
+        }
+    }
+    return need;
+}
+
+uint8_t IMU_pendingChannels(uint32_t now_us) {
+    uint8_t due;
+    return pending_channels(now_us, &due);
+}
+
+void IMU_publish(const IMU_Sample* s, uint8_t channels) {
+    int16_t v[10];
+    sample_values(s, v);
+    IMU_Subscriber* next;
+    for (IMU_Subscriber* sub = subscribers; sub; sub = next) {
+        // Обработчик может удалить свою подписку
+        next = sub->next;
+        // Подписка получает отсчет, только если в нем есть все ее каналы
+        if ((sub->channels & channels) != sub->channels) {
+            continue;
+        }
+        if (sub->filter == IMU_DECIMATE_MEAN && sub->count < 0xFFFF) {
+            for (uint8_t i = 0; i < 10; i++) {
+                sub->sum[i] += v[i];
+            }
+            sub->count++;
+            sub->next_input_us = s->t_us + sub->period_us / IMU_PUBSUB_OVERSAMPLE;
+        }
+        if (is_due(sub, s->t_us)) {
+            deliver(sub, s, s->t_us);
+        }
+    }
+}
+
+bool IMU_poll() {
+    uint32_t now = micros();
+    uint8_t due;
+    uint8_t need = pending_channels(now, &due);
+    if (!need) {
+        return false;
+    }
+    // Магнитометр нужен только в сумму усреднения (чтения в IMU_PUBSUB_OVERSAMPLE
+    // раз чаще выдачи): BMM150 на основной шине читается без ожидания измерения
+    if (!(due & IMU_CHANNEL_MAG)) {
+        need |= IMU_CHANNEL_MAG_NOWAIT;
+    }
+    // Читаются только каналы, нужные подпискам в этот момент; раздаются
+    // только прочитанные — подписка без своих каналов отсчет не получает
+    IMU_Sample s;
+    memset(&s, 0, sizeof(s));
+    uint8_t got = IMU_readChannels(need, s.acc, s.gyr, s.mag, &s.rhall);
+    s.t_us = now;
+    if (got) {
+        IMU_publish(&s, got);
+    }
+    return true;
+}
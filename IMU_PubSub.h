@@ -0,0 +1,127 @@
+/**
+ * @file IMU_PubSub.h
+ * @brief Раздача одного потока отсчетов нескольким потребителям с разной частотой
+ * 
+ * Каждый потребитель регистрирует подписку: маску каналов, частоту и фильтр
+ * прореживания. Один цикл опроса (IMU_poll) читает датчик только когда
+ * это нужно хотя бы одной подписке и раздает один и тот же отсчет всем,
+ * без повторных чтений шины. Заменяет раздельные вызовы
+ * IMU_readDataWithFrequency(), которые делят общее статическое состояние.
+ * 
+ * Фильтры прореживания:
+ * - IMU_DECIMATE_LATEST — к сроку выдается последний отсчет
+ * - IMU_DECIMATE_MEAN — среднее всех отсчетов с прошлой выдачи (защита
+ *   от наложения спектров): в сумму попадает каждый прочитанный отсчет,
+ *   а сама подписка требует чтения не реже IMU_PUBSUB_OVERSAMPLE раз за период
+ * 
+ * Пример:
+ * @code
+ * IMU_Subscriber ctrl, fusion, logger;
+ * IMU_subscribe(&ctrl, IMU_CHANNEL_GYR, 1000, IMU_DECIMATE_LATEST, on_gyro, nullptr);
+ * IMU_subscribe(&fusion, IMU_CHANNEL_ALL, 100, IMU_DECIMATE_MEAN, on_fusion, nullptr);
+ * IMU_subscribe(&logger, IMU_CHANNEL_ALL, 1, IMU_DECIMATE_MEAN, on_log, nullptr);
+ * 
+ * void loop() {
+ *     IMU_poll();
+ * }
+ * @endcode
+ * 
+ * Подписки хранятся в списке без динамической памяти: структура
+ * IMU_Subscriber принадлежит вызывающему и должна жить до IMU_unsubscribe().
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_PUBSUB_H
+#define IMU_PUBSUB_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Минимальное число отсчетов на период для подписки с усреднением
+#ifndef IMU_PUBSUB_OVERSAMPLE
+#define IMU_PUBSUB_OVERSAMPLE 8
+#endif
+
+// Фильтр прореживания
+enum IMU_Decimation {
+    IMU_DECIMATE_LATEST = 0,
+    IMU_DECIMATE_MEAN = 1
+};
+
+/**
+ * @brief Обработчик отсчета подписки
+ * 
+ * @param s Отсчет; каналы вне маски подписки равны нулю
+ * @param ctx Контекст, переданный в IMU_subscribe()
+ */
+typedef void (*IMU_SampleCallback)(const IMU_Sample* s, void* ctx);
+
+struct IMU_Subscriber {
+    uint8_t channels;             // Маска IMU_CHANNEL_*
+    uint8_t filter;               // IMU_Decimation
+    uint32_t period_us;           // Период выдачи (0 — каждый отсчет)
+    IMU_SampleCallback callback;
+    void* ctx;
+
+    uint32_t next_due_us;         // Срок следующей выдачи
+    uint32_t next_input_us;       // Срок следующего отсчета в сумму (IMU_DECIMATE_MEAN)
+    bool started;                 // Срок уже назначен
+    uint16_t count;               // Отсчетов в сумме (IMU_DECIMATE_MEAN)
+    int32_t sum[10];              // Суммы acc[3], gyr[3], mag[3], rhall
+    uint32_t delivered;           // Выдано отсчетов
+    IMU_Subscriber* next;
+};
+
+/**
+ * @brief Регистрирует подписку (повторная регистрация меняет параметры)
+ * 
+ * @param sub Состояние подписки (принадлежит вызывающему)
+ * @param channels Маска IMU_CHANNEL_*
+ * @param rate_hz Частота выдачи (Гц); 0 — каждый прочитанный отсчет
+ * @param filter IMU_DECIMATE_LATEST или IMU_DECIMATE_MEAN
+ * @param callback Обработчик
+ * @param ctx Контекст обработчика
+ */
+void IMU_subscribe(IMU_Subscriber* sub, uint8_t channels, float rate_hz, uint8_t filter,
+                   IMU_SampleCallback callback, void* ctx);
+
+/**
+ * @brief Удаляет подписку
+ */
+void IMU_unsubscribe(IMU_Subscriber* sub);
+
+/**
+ * @brief Маска каналов, которые нужны подпискам к моменту now_us
+ * 
+ * Учитывает подписки, срок выдачи которых наступил, и подписки с усреднением,
+ * которым нужен очередной отсчет в сумму.
+ */
+uint8_t IMU_pendingChannels(uint32_t now_us);
+
+/**
+ * @brief Раздает отсчет подпискам (для отсчетов, полученных вне IMU_poll)
+ * 
+ * @param s Отсчет; время берется из s->t_us
+ * @param channels Каналы, действительные в отсчете
+ */
+void IMU_publish(const IMU_Sample* s, uint8_t channels);
+
+/**
+ * @brief Цикл опроса: читает датчик, если это нужно подпискам, и раздает отсчет
+ * 
+ * Читаются только каналы, нужные подпискам в этот момент (IMU_readChannels):
+ * например, при подписках на гироскоп 1 кГц и на 9 осей 100 Гц
+ * (IMU_DECIMATE_LATEST) между выдачами 100 Гц читаются только 6 байт гироскопа.
+ * 
+ * Подписки получают только прочитанные каналы: при ошибке чтения или без
+ * магнитометра подписка на его канал отсчет не получает. Если магнитометр
+ * нужен только в сумму усреднения, BMM150 на основной шине читается без
+ * ожидания измерения (IMU_CHANNEL_MAG_NOWAIT).
+ * 
+ * @return true если было выполнено чтение
+ */
+bool IMU_poll();
+
+#endif // IMU_PUBSUB_H
@@ -0,0 +1,94 @@
+/**
+ * @file IMU_Queue.cpp
+ * @brief Реализация очереди отсчетов с одним производителем и одним потребителем
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Queue.h"
+
+// Чтение индекса другой стороны (acquire) и публикация своего (release).
+// На AVR одно ядро и однобайтовые индексы: достаточно барьера компилятора,
+// чтобы копирование отсчета не было переставлено относительно индекса.
+#if defined(__AVR__)
+#define QUEUE_LOAD(x) ((x))
+#define QUEUE_STORE(x, v) do { __asm__ __volatile__("" ::: "memory"); (x) = (v); } while (0)
+#define QUEUE_ACQUIRE() __asm__ __volatile__("" ::: "memory")
+#else
+#define QUEUE_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define QUEUE_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define QUEUE_ACQUIRE() do {} while (0)
+#endif
+
+bool IMU_queueInit(IMU_Queue* q, IMU_Sample* buf, uint16_t capacity) {
+    if (capacity < 2 || capacity > IMU_QUEUE_MAX_CAPACITY || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    q->buf = buf;
+    q->mask = (IMU_QueueIndex)(capacity - 1);
+    q->head = 0;
+    q->tail = 0;
+    q->overruns = 0;
+    return true;
+}
+
+bool IMU_queuePush(IMU_Queue* q, const IMU_Sample* s) {
+    IMU_QueueIndex head = q->head;
+    IMU_QueueIndex tail = QUEUE_LOAD(q->tail);
+    QUEUE_ACQUIRE();
+    if ((IMU_QueueIndex)(head - tail) > q->mask) {
+        q->overruns = q->overruns + 1;
+        return false;
+    }
+    q->buf[head & q->mask] = *s;
+    QUEUE_STORE(q->head, (IMU_QueueIndex)(head + 1));
+    return true;
+}
+
+bool IMU_queueSample(IMU_Queue* q) {
+    IMU_Sample s;
+    s.t_us = micros();
+    IMU_readData(s.acc, s.gyr, s.mag, &s.rhall);
+    return IMU_queuePush(q, &s);
+}
+
+bool IMU_queuePop(IMU_Queue* q, IMU_Sample* out) {
+    return IMU_queuePopBatch(q, out, 1) == 1;
+}
+
+size_t IMU_queuePopBatch(IMU_Queue* q, IMU_Sample* out, size_t max) {
+    IMU_QueueIndex tail = q->tail;
+    IMU_QueueIndex head = QUEUE_LOAD(q->head);
+    QUEUE_ACQUIRE();
+    size_t n = (IMU_QueueIndex)(head - tail);
+    if (n > max) {
+        n = max;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = q->buf[(IMU_QueueIndex)(tail + i) & q->mask];
+    }
+    if (n) {
+        QUEUE_STORE(q->tail, (IMU_QueueIndex)(tail + n));
+    }
+    return n;
+}
+
+size_t IMU_queueCount(const IMU_Queue* q) {
+    IMU_QueueIndex head = QUEUE_LOAD(q->head);
+    IMU_QueueIndex tail = QUEUE_LOAD(q->tail);
+    return (IMU_QueueIndex)(head - tail);
+}
+
+uint32_t IMU_queueOverruns(const IMU_Queue* q) {
+#if defined(__AVR__)
+    // 32-битный счетчик на 8-битном ядре читается при запрещенных прерываниях
+    uint8_t sreg = SREG;
+    cli();
+    uint32_t v = q->overruns;
+    SREG = sreg;
+    return v;
+#else
+    return QUEUE_LOAD(q->overruns);
+#endif
+}
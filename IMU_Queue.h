@@ -0,0 +1,113 @@
+/**
+ * @file IMU_Queue.h
+ * @brief Очередь отсчетов без блокировок: один производитель, один потребитель
+ * 
+ * Разделяет получение данных и их обработку: производитель (обработчик
+ * прерывания или задача RTOS, опрашивающая датчик) кладет отсчеты IMU_Sample,
+ * приложение забирает их по одному или пачками. Медленный потребитель
+ * больше не приводит к пропуску отсчетов датчика — при переполнении
+ * отбрасывается новый отсчет и увеличивается счетчик переполнений.
+ * 
+ * Свойства:
+ * - Операции без ожидания (wait-free): ни производитель, ни потребитель
+ *   никогда не ждут друг друга и не запрещают прерывания
+ * - Индекс записи меняет только производитель, индекс чтения — только потребитель
+ * - На 32-битных платформах (ARM, ESP32, хост) используется порядок памяти
+ *   acquire/release (__atomic), на AVR — однобайтовые индексы (атомарны
+ *   на 8-битном ядре) и барьер компилятора
+ * 
+ * Пример:
+ * @code
+ * IMU_Sample buf[32];
+ * IMU_Queue q;
+ * IMU_queueInit(&q, buf, 32);
+ * 
+ * // задача опроса датчика
+ * IMU_queueSample(&q);
+ * 
+ * // приложение
+ * IMU_Sample batch[8];
+ * size_t n = IMU_queuePopBatch(&q, batch, 8);
+ * @endcode
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_QUEUE_H
+#define IMU_QUEUE_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Тип индексов: чтение и запись индекса должны быть атомарны на целевом ядре
+#if defined(__AVR__)
+typedef uint8_t IMU_QueueIndex;
+#define IMU_QUEUE_MAX_CAPACITY 128
+#else
+typedef uint32_t IMU_QueueIndex;
+#define IMU_QUEUE_MAX_CAPACITY 32768
+#endif
+
+struct IMU_Queue {
+    IMU_Sample* buf;
+    IMU_QueueIndex mask;               // Емкость - 1 (емкость — степень двойки)
+    volatile IMU_QueueIndex head;      // Свободно бегущий индекс записи (производитель)
+    volatile IMU_QueueIndex tail;      // Свободно бегущий индекс чтения (потребитель)
+    volatile uint32_t overruns;        // Отброшено отсчетов из-за переполнения (производитель)
+};
+
+/**
+ * @brief Инициализирует очередь
+ * 
+ * @param q Очередь
+ * @param buf Буфер отсчетов
+ * @param capacity Емкость: степень двойки от 2 до IMU_QUEUE_MAX_CAPACITY
+ * @return false если емкость недопустима
+ * 
+ * @note Вызывается до запуска производителя и потребителя
+ */
+bool IMU_queueInit(IMU_Queue* q, IMU_Sample* buf, uint16_t capacity);
+
+/**
+ * @brief Добавляет отсчет (вызывается только производителем)
+ * 
+ * @return false если очередь полна: отсчет отброшен, счетчик переполнений увеличен
+ */
+bool IMU_queuePush(IMU_Queue* q, const IMU_Sample* s);
+
+/**
+ * @brief Читает датчик (IMU_readData с меткой micros()) и добавляет отсчет
+ * 
+ * Для задачи опроса RTOS или цикла loop(); из обработчика прерывания
+ * на AVR вызывать нельзя, так как чтение по I2C требует прерываний.
+ * 
+ * @return false если очередь полна
+ */
+bool IMU_queueSample(IMU_Queue* q);
+
+/**
+ * @brief Извлекает один отсчет (вызывается только потребителем)
+ * 
+ * @return false если очередь пуста
+ */
+bool IMU_queuePop(IMU_Queue* q, IMU_Sample* out);
+
+/**
+ * @brief Извлекает до max отсчетов одним обращением к индексам
+ * 
+ * @return Количество извлеченных отсчетов
+ */
+size_t IMU_queuePopBatch(IMU_Queue* q, IMU_Sample* out, size_t max);
+
+/**
+ * @brief Количество отсчетов в очереди (оценка, корректна для любой из сторон)
+ */
+size_t IMU_queueCount(const IMU_Queue* q);
+
+/**
+ * @brief Количество отсчетов, отброшенных из-за переполнения
+ */
+uint32_t IMU_queueOverruns(const IMU_Queue* q);
+
+#endif // IMU_QUEUE_H
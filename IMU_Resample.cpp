@@ -0,0 +1,257 @@
+/**
+ * @file IMU_Resample.cpp
+ * @brief Реализация выравнивания отсчетов на равномерную сетку времени
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Resample.h"
+
+// Разрядность дроби интерполяции
+#define FRAC_BITS 12
+
+// Наибольший интервал между отсчетами, при котором выполняется интерполяция (мкс):
+// (t - t0) << FRAC_BITS должно помещаться в uint32_t. При большем интервале
+// (пропуск данных) берется последнее значение
+#define MAX_INTERP_GAP (1UL << (32 - FRAC_BITS))
+
+// Количество значений в потоке
+static uint8_t stream_width(uint8_t stream) {
+    return stream == IMU_RESAMPLE_STREAM_MAG ? 4 : 3;
+}
+
+/**
+ * @brief Возвращает указатель на значения потока в отсчете
+ */
+static int16_t* slot_channels(IMU_Sample* s, uint8_t stream) {
+    switch (stream) {
+        case IMU_RESAMPLE_STREAM_ACC: return s->acc;
+        case IMU_RESAMPLE_STREAM_GYR: return s->gyr;
+        default: return s->mag;
+    }
+}
+
+/**
+ * @brief Записывает значения потока в узел (для магнитометра — и rhall)
+ */
+static void slot_store(IMU_ResampleSlot* slot, uint8_t stream, const int16_t* v) {
+    int16_t* dst = slot_channels(&slot->s, stream);
+    dst[0] = v[0];
+    dst[1] = v[1];
+    dst[2] = v[2];
+    if (stream == IMU_RESAMPLE_STREAM_MAG) {
+        slot->s.rhall = v[3];
+    }
+    slot->filled |= (uint8_t)(1 << stream);
+}
+
+/**
+ * @brief Интерполирует поток в момент t (t не позже последнего отсчета потока)
+ */
+static void stream_value_at(const IMU_ResampleStream* st, uint8_t width, uint32_t t, int16_t* out) {
+    const int16_t* cur = st->v[1];
+    uint32_t span = st->t[1] - st->t[0];
+    if (st->count < 2 || span == 0 || span > MAX_INTERP_GAP || t <= st->t[0]) {
+        for (uint8_t i = 0; i < width; i++) {
+            out[i] = (st->count < 2 || t > st->t[0]) ? cur[i] : st->v[0][i];
+        }
+        return;
+    }
+
+    // Разность каналов до 17 бит и дробь 12 бит помещаются в int32
+    int32_t frac = (int32_t)(((t - st->t[0]) << FRAC_BITS) / span);
+    for (uint8_t i = 0; i < width; i++) {
+        int32_t a = st->v[0][i];
+        int32_t d = (int32_t)cur[i] - a;
+        out[i] = (int16_t)(a + ((d * frac) >> FRAC_BITS));
+    }
+}
+
+static IMU_ResampleSlot* slot_at(IMU_Resampler* r, uint8_t k) {
+    return &r->slots[(uint8_t)(r->head + k) % IMU_RESAMPLE_SLOTS];
+}
+
+/**
+ * @brief Делает первый ожидающий узел готовым; незаполненные потоки берутся по последнему значению
+ */
+static void complete_front(IMU_Resampler* r) {
+    IMU_ResampleSlot* slot = slot_at(r, r->ready);
+    for (uint8_t s = 0; s < IMU_RESAMPLE_STREAMS; s++) {
+        uint8_t bit = (uint8_t)(1 << s);
+        if ((r->active & bit) && !(slot->filled & bit)) {
+            const IMU_ResampleStream* st = &r->streams[s];
+            if (st->count) {
+                slot_store(slot, s, st->v[1]);
+            }
+            r->held++;
+            // Поток больше не должен заполнять этот узел
+            if ((int32_t)(st->next_t - slot->s.t_us) <= 0) {
+                r->streams[s].next_t = slot->s.t_us + r->period_us;
+            }
+        }
+    }
+    r->ready++;
+    r->emitted++;
+    r->next_emit_t += r->period_us;
+}
+
+/**
+ * @brief Освобождает место в кольце: выдает первый ожидающий узел или вытесняет старый готовый
+ */
+static void make_room(IMU_Resampler* r) {
+    if (r->ready < r->used) {
+        complete_front(r);
+    }
+    if (r->ready == r->used && r->used == IMU_RESAMPLE_SLOTS) {
+        r->head = (uint8_t)(r->head + 1) % IMU_RESAMPLE_SLOTS;
+        r->used--;
+        r->ready--;
+        r->dropped++;
+    }
+}
+
+/**
+ * @brief После разрыва данных переносит сетку к узлам, которые поместятся в кольцо
+ * 
+ * Узлы раньше t_us - (IMU_RESAMPLE_SLOTS - 1) периодов все равно были бы
+ * вытеснены новыми, поэтому они не создаются по одному: узлы кольца
+ * выдаются и вытесняются, остальные учитываются в emitted и dropped сразу.
+ */
+static void skip_gap(IMU_Resampler* r, IMU_ResampleStream* st, uint32_t t_us) {
+    if ((int32_t)(t_us - st->next_t) < 0) {
+        return;
+    }
+    uint32_t p = r->period_us;
+    uint32_t last = st->next_t + (t_us - st->next_t) / p * p;
+    uint32_t first_kept = last - (uint32_t)(IMU_RESAMPLE_SLOTS - 1) * p;
+    uint32_t ring_end = r->next_emit_t + (uint32_t)(r->used - r->ready) * p;
+    if ((int32_t)(first_kept - ring_end) <= 0) {
+        return;
+    }
+
+    while (r->ready < r->used) {
+        complete_front(r);
+    }
+    r->head = (uint8_t)(r->head + r->used) % IMU_RESAMPLE_SLOTS;
+    r->dropped += r->used;
+    r->used = 0;
+    r->ready = 0;
+
+    uint32_t skipped = (first_kept - r->next_emit_t) / p;
+    r->emitted += skipped;
+    r->dropped += skipped;
+    r->next_emit_t = first_kept;
+    st->next_t = first_kept;
+}
+
+void IMU_resampleInit(IMU_Resampler* r, uint32_t period_us, uint32_t max_latency_us, uint8_t active) {
+    memset(r, 0, sizeof(*r));
+    r->period_us = period_us ? period_us : 1;
+    r->max_latency_us = max_latency_us;
+    r->active = active & IMU_RESAMPLE_ALL;
+}
+
+void IMU_resamplePush(IMU_Resampler* r, uint8_t stream, uint32_t t_us, const int16_t* v) {
+    if (stream >= IMU_RESAMPLE_STREAMS) {
+        return;
+    }
+    if (!(r->active & (1u << stream))) {
+        return;
+    }
+
+    if (!r->started) {
+        r->started = true;
+        r->next_emit_t = t_us;
+    }
+    if ((int32_t)(t_us - r->newest_t) > 0 || r->newest_t == 0) {
+        r->newest_t = t_us;
+    }
+
+    IMU_ResampleStream* st = &r->streams[stream];
+    uint8_t width = stream_width(stream);
+    if (st->count > 0 && (int32_t)(t_us - st->t[1]) <= 0) {
+        return; // Время потока не возрастает — отсчет отбрасывается
+    }
+    st->t[0] = st->t[1];
+    memcpy(st->v[0], st->v[1], sizeof(st->v[0]));
+    st->t[1] = t_us;
+    memcpy(st->v[1], v, width * sizeof(int16_t));
+    // Поток начинает с первого ожидающего узла (первый отсчет потока или
+    // отставание после паузы): более ранние узлы уже выданы
+    if (st->count == 0 || (int32_t)(st->next_t - r->next_emit_t) < 0) {
+        st->next_t = r->next_emit_t;
+    }
+    if (st->count < 2) {
+        st->count++;
+    }
+    skip_gap(r, st, t_us);
+
+    // Заполняем узлы сетки, которые поток уже прошел
+    while ((int32_t)(st->next_t - t_us) <= 0) {
+        uint32_t t = st->next_t;
+        st->next_t += r->period_us;
+        if ((int32_t)(t - r->next_emit_t) < 0) {
+            continue; // Узел уже выдан
+        }
+
+        uint32_t k = r->ready + (t - r->next_emit_t) / r->period_us;
+        while (k >= IMU_RESAMPLE_SLOTS) {
+            make_room(r);
+            if ((int32_t)(t - r->next_emit_t) < 0) {
+                break;
+            }
+            k = r->ready + (t - r->next_emit_t) / r->period_us;
+        }
+        if ((int32_t)(t - r->next_emit_t) < 0) {
+            continue;
+        }
+
+        while (r->used <= k) {
+            IMU_ResampleSlot* slot = slot_at(r, r->used);
+            memset(slot, 0, sizeof(*slot));
+            slot->s.t_us = r->next_emit_t + (r->used - r->ready) * r->period_us;
+            r->used++;
+        }
+
+        int16_t val[4];
+        stream_value_at(st, width, t, val);
+        slot_store(slot_at(r, (uint8_t)k), stream, val);
+    }
+
+    // Выдаем полностью заполненные узлы и узлы, ожидающие дольше допустимого
+    while (r->ready < r->used) {
+        IMU_ResampleSlot* slot = slot_at(r, r->ready);
+        if (slot->filled == r->active) {
+            r->ready++;
+            r->emitted++;
+            r->next_emit_t += r->period_us;
+        } else if (r->newest_t - slot->s.t_us > r->max_latency_us) {
+            complete_front(r);
+        } else {
+            break;
+        }
+    }
+}
+
+void IMU_resamplePushReading(IMU_Resampler* r, const int16_t* acc, const int16_t* gyr,
+                             const int16_t* mag, int16_t rhall) {
+    uint32_t accgyr_us, mag_us;
+    IMU_getSampleTimes(&accgyr_us, &mag_us);
+
+    IMU_resamplePush(r, IMU_RESAMPLE_STREAM_ACC, accgyr_us, acc);
+    IMU_resamplePush(r, IMU_RESAMPLE_STREAM_GYR, accgyr_us, gyr);
+    const int16_t m[4] = { mag[0], mag[1], mag[2], rhall };
+    IMU_resamplePush(r, IMU_RESAMPLE_STREAM_MAG, mag_us, m);
+}
+
+bool IMU_resamplePop(IMU_Resampler* r, IMU_Sample* out) {
+    if (r->ready == 0) {
+        return false;
+    }
+    *out = r->slots[r->head].s;
+    r->head = (uint8_t)(r->head + 1) % IMU_RESAMPLE_SLOTS;
+    r->used--;
+    r->ready--;
+    return true;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file IMU_Resample.h
+ * @brief Выравнивание отсчетов акселерометра, гироскопа и магнитометра на равномерную сетку времени
+ * 
+ * Каждый датчик подает отсчеты со своими метками времени и со своей частотой.
+ * Модуль линейно интерполирует каждый канал в узлы общей сетки с шагом
+ * period_us и выдает согласованные 9-осевые отсчеты IMU_Sample с равными
+ * интервалами.
+ * 
+ * Свойства:
+ * - Фиксированная память: IMU_RESAMPLE_SLOTS узлов сетки в структуре IMU_Resampler
+ * - Ограниченная задержка: узел выдается, когда все каналы прошли его время,
+ *   либо не позже max_latency_us после самого нового отсчета; отсутствующий
+ *   канал в этом случае берется по последнему известному значению
+ * - Целочисленная арифметика (дробь интерполяции — 12 бит), без FPU
+ * 
+ * Пример:
+ * @code
+ * IMU_Resampler rs;
+ * IMU_resampleInit(&rs, 10000, 20000, IMU_RESAMPLE_ALL); // 100 Гц, задержка ≤ 20 мс
+ * 
+ * IMU_readData(acc, gyr, mag, &rhall);
+ * IMU_resamplePushReading(&rs, acc, gyr, mag, rhall);
+ * 
+ * IMU_Sample s;
+ * while (IMU_resamplePop(&rs, &s)) {
+ *     fusion_update(&s);
+ * }
+ * @endcode
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_RESAMPLE_H
+#define IMU_RESAMPLE_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Количество узлов сетки, ожидающих данных или чтения (ограничивает память и задержку)
+#ifndef IMU_RESAMPLE_SLOTS
+#define IMU_RESAMPLE_SLOTS 4
+#endif
+
+// Потоки входных данных
+enum IMU_ResampleStreamId {
+    IMU_RESAMPLE_STREAM_ACC = 0,
+    IMU_RESAMPLE_STREAM_GYR = 1,
+    IMU_RESAMPLE_STREAM_MAG = 2, // x, y, z, rhall
+    IMU_RESAMPLE_STREAMS = 3
+};
+
+// Маски активных потоков
+#define IMU_RESAMPLE_ACC (1 << IMU_RESAMPLE_STREAM_ACC)
+#define IMU_RESAMPLE_GYR (1 << IMU_RESAMPLE_STREAM_GYR)
+#define IMU_RESAMPLE_MAG (1 << IMU_RESAMPLE_STREAM_MAG)
+#define IMU_RESAMPLE_ALL (IMU_RESAMPLE_ACC | IMU_RESAMPLE_GYR | IMU_RESAMPLE_MAG)
+
+// Состояние одного входного потока: два последних отсчета
+struct IMU_ResampleStream {
+    uint32_t t[2];      // Время предыдущего и последнего отсчета
+    int16_t v[2][4];    // Значения предыдущего и последнего отсчета
+    uint8_t count;      // Количество полученных отсчетов (0, 1 или 2)
+    uint32_t next_t;    // Ближайший узел сетки, еще не заполненный этим потоком (с первого отсчета потока)
+};
+
+// Узел сетки
+struct IMU_ResampleSlot {
+    IMU_Sample s;       // Значения в узле (s.t_us — время узла)
+    uint8_t filled;     // Маска потоков, заполнивших узел
+};
+
+struct IMU_Resampler {
+    uint32_t period_us;       // Шаг выходной сетки
+    uint32_t max_latency_us;  // Максимальная задержка выдачи узла
+    uint8_t active;           // Маска активных потоков
+    bool started;
+
+    IMU_ResampleStream streams[IMU_RESAMPLE_STREAMS];
+    IMU_ResampleSlot slots[IMU_RESAMPLE_SLOTS];
+    uint8_t head;             // Самый старый узел
+    uint8_t used;             // Узлов в кольце (готовые + ожидающие)
+    uint8_t ready;            // Готовых узлов в начале кольца
+    uint32_t next_emit_t;     // Время первого ожидающего узла
+    uint32_t newest_t;        // Время самого нового входного отсчета
+
+    // Статистика
+    uint32_t emitted;         // Выдано узлов
+    uint32_t held;            // Каналов, взятых по последнему значению (из-за задержки или памяти)
+    uint32_t dropped;         // Узлов, вытесненных до чтения (в т.ч. пропущенных после разрыва данных)
+};
+
+/**
+ * @brief Инициализирует выравниватель
+ * 
+ * @param r Состояние
+ * @param period_us Шаг выходной сетки (мкс)
+ * @param max_latency_us Максимальная задержка выдачи узла относительно самого нового отсчета (мкс)
+ * @param active Маска потоков (IMU_RESAMPLE_ACC | IMU_RESAMPLE_GYR | IMU_RESAMPLE_MAG)
+ * 
+ * Сетка начинается с времени первого поданного отсчета.
+ */
+void IMU_resampleInit(IMU_Resampler* r, uint32_t period_us, uint32_t max_latency_us, uint8_t active);
+
+/**
+ * @brief Подает отсчет одного потока
+ * 
+ * @param r Состояние
+ * @param stream Поток (IMU_RESAMPLE_STREAM_*)
+ * @param t_us Время отсчета (micros()); в пределах потока должно возрастать
+ * @param v Значения: 3 оси, для магнитометра — 3 оси и rhall
+ * 
+ * Отсчет несуществующего или неактивного потока игнорируется.
+ */
+void IMU_resamplePush(IMU_Resampler* r, uint8_t stream, uint32_t t_us, const int16_t* v);
+
+/**
+ * @brief Подает результат IMU_readData() с временами из IMU_getSampleTimes()
+ */
+void IMU_resamplePushReading(IMU_Resampler* r, const int16_t* acc, const int16_t* gyr,
+                             const int16_t* mag, int16_t rhall);
+
+/**
+ * @brief Забирает следующий готовый отсчет сетки
+ * 
+ * @return false если готовых отсчетов нет
+ */
+bool IMU_resamplePop(IMU_Resampler* r, IMU_Sample* out);
+
+#endif // IMU_RESAMPLE_H
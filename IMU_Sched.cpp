@@ -0,0 +1,166 @@
+/**
+ * @file IMU_Sched.cpp
+ * @brief Реализация планировщика опроса по абсолютным срокам
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Sched.h"
+
+/**
+ * @brief Номер корзины гистограммы для запаздывания late (мкс)
+ */
+static uint8_t hist_bin(uint32_t late) {
+    if (late < 4) {
+        return (uint8_t)late;
+    }
+    uint8_t octave = 2;
+    while ((late >> (octave + 1)) != 0 && octave < 31) {
+        octave++;
+    }
+    uint8_t bin = 4 + (octave - 2) * 2 + ((late >> (octave - 1)) & 1);
+    return bin < IMU_SCHED_HIST_BINS ? bin : IMU_SCHED_HIST_BINS - 1;
+}
+
+/**
+ * @brief Верхняя граница корзины (мкс)
+ */
+static uint32_t hist_upper(uint8_t bin) {
+    if (bin < 4) {
+        return bin;
+    }
+    uint8_t octave = 2 + (bin - 4) / 2;
+    uint32_t base = 1UL << octave;
+    uint32_t half = base >> 1;
+    return base + half * ((bin - 4) % 2 + 1) - 1;
+}
+
+/**
+ * @brief Сдвигает срок на один период
+ */
+static void advance(IMU_Scheduler* s) {
+    uint16_t frac = (uint16_t)s->deadline_frac + s->period_frac;
+    s->deadline_us += s->period_us + (frac >> 8);
+    s->deadline_frac = (uint8_t)frac;
+}
+
+/**
+ * @brief Отмечает запаздывание в гистограмме
+ * 
+ * При переполнении корзины все счетчики делятся пополам:
+ * форма распределения сохраняется, а память остается постоянной.
+ */
+static void record_late(IMU_Scheduler* s, uint32_t late) {
+    uint8_t bin = hist_bin(late);
+    if (s->hist[bin] == 0xFFFF) {
+        for (uint8_t i = 0; i < IMU_SCHED_HIST_BINS; i++) {
+            s->hist[i] >>= 1;
+        }
+    }
+    s->hist[bin]++;
+    if (late > s->max_late_us) {
+        s->max_late_us = late;
+    }
+}
+
+void IMU_schedInit(IMU_Scheduler* s, float frequency, uint8_t policy) {
+    memset(s, 0, sizeof(*s));
+    if (frequency < 0.1f) {
+        frequency = 0.1f; // Период должен помещаться в 32 бита (1/256 мкс)
+    }
+    // Период в 1/256 мкс: ошибка частоты не больше 2e-3 мкс на период
+    uint32_t period_q8 = (uint32_t)(256.0e6f / frequency + 0.5f);
+    if (period_q8 < 256) {
+        period_q8 = 256;
+    }
+    s->period_us = period_q8 >> 8;
+    s->period_frac = (uint8_t)period_q8;
+    s->policy = policy;
+}
+
+bool IMU_schedDueAt(IMU_Scheduler* s, uint32_t now_us) {
+    bool first = !s->started;
+    if (first) {
+        s->started = true;
+        s->deadline_us = now_us;
+        s->deadline_frac = 0;
+        s->last_us = now_us;
+    }
+    int32_t late = (int32_t)(now_us - s->deadline_us);
+    if (late < 0) {
+        return false;
+    }
+
+    record_late(s, (uint32_t)late);
+    if (!first) {
+        s->elapsed_us += now_us - s->last_us;
+        s->intervals++;
+    }
+    s->last_us = now_us;
+    s->ticks++;
+    advance(s);
+
+    // Отставание больше периода: отработать подряд или пропустить сроки
+    uint32_t limit = s->policy == IMU_SCHED_CATCH_UP ? s->period_us * IMU_SCHED_MAX_BACKLOG : 0;
+    while ((int32_t)(now_us - s->deadline_us) >= 0 &&
+           (uint32_t)(now_us - s->deadline_us) >= limit) {
+        advance(s);
+        s->missed++;
+    }
+    return true;
+}
+
+bool IMU_schedDue(IMU_Scheduler* s) {
+    return IMU_schedDueAt(s, micros());
+}
+
+uint32_t IMU_schedRemainingUs(const IMU_Scheduler* s) {
+    if (!s->started) {
+        return 0;
+    }
+    int32_t left = (int32_t)(s->deadline_us - micros());
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void IMU_schedStats(const IMU_Scheduler* s, IMU_SchedStats* st) {
+    st->ticks = s->ticks;
+    st->missed = s->missed;
+    st->rate_hz = s->elapsed_us > 0 ? (float)(s->intervals * 1.0e6 / (double)s->elapsed_us) : 0.0f;
+    st->late_max_us = s->max_late_us;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < IMU_SCHED_HIST_BINS; i++) {
+        total += s->hist[i];
+    }
+    uint32_t* out[3] = {&st->late_p50_us, &st->late_p90_us, &st->late_p99_us};
+    const uint8_t pct[3] = {50, 90, 99};
+    for (uint8_t k = 0; k < 3; k++) {
+        *out[k] = 0;
+        if (total == 0) {
+            continue;
+        }
+        uint32_t target = (total * pct[k] + 99) / 100;
+        uint32_t acc = 0;
+        for (uint8_t i = 0; i < IMU_SCHED_HIST_BINS; i++) {
+            acc += s->hist[i];
+            if (acc >= target) {
+                *out[k] = hist_upper(i);
+                break;
+            }
+        }
+        // Верхняя граница корзины не бывает больше наблюдаемого максимума
+        if (*out[k] > s->max_late_us) {
+            *out[k] = s->max_late_us;
+        }
+    }
+}
+
+void IMU_schedResetStats(IMU_Scheduler* s) {
+    s->elapsed_us = 0;
+    s->intervals = 0;
+    s->ticks = 0;
+    s->missed = 0;
+    s->max_late_us = 0;
+    memset(s->hist, 0, sizeof(s->hist));
+}
@@ -0,0 +1,121 @@
+/**
+ * @file IMU_Sched.h
+ * @brief Планировщик опроса по абсолютным срокам в микросекундах
+ * 
+ * Сроки отсчетов лежат на сетке start + k·T, где период T хранится
+ * с точностью 1/256 мкс: запоздание одного вызова не сдвигает следующие
+ * сроки, а заданная частота выдерживается часами (300 Гц — это 300 Гц,
+ * а не 333 Гц, как при целом числе миллисекунд).
+ * 
+ * Если вызовы опаздывают больше чем на период, действует политика:
+ * - IMU_SCHED_CATCH_UP — пропущенные сроки отрабатываются подряд
+ *   (не более IMU_SCHED_MAX_BACKLOG периодов; сверх этого — как SKIP)
+ * - IMU_SCHED_SKIP — пропущенные сроки отбрасываются, следующий срок —
+ *   ближайший будущий на той же сетке
+ * 
+ * Статистика: число отсчетов и пропущенных сроков, фактическая частота,
+ * запаздывание (p50/p90/p99 и максимум) по гистограмме с шагом
+ * в полоктавы — без хранения отдельных отсчетов.
+ * 
+ * Пример:
+ * @code
+ * IMU_Scheduler sched;
+ * IMU_schedInit(&sched, 300.0f, IMU_SCHED_CATCH_UP);
+ * 
+ * void loop() {
+ *     if (IMU_schedDue(&sched)) {
+ *         IMU_readData(acc, gyr, mag, &rhall);
+ *     }
+ * }
+ * @endcode
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_SCHED_H
+#define IMU_SCHED_H
+
+#include <Arduino.h>
+
+// Наибольшее отставание (в периодах), которое IMU_SCHED_CATCH_UP отрабатывает подряд
+#ifndef IMU_SCHED_MAX_BACKLOG
+#define IMU_SCHED_MAX_BACKLOG 4
+#endif
+
+// Корзины гистограммы запаздывания: 0..3 мкс, затем по две на октаву до 65.5 мс
+// (последняя корзина — 49.2..65.5 мс — собирает и все большие запаздывания)
+#define IMU_SCHED_HIST_BINS 32
+
+// Политика для пропущенных сроков
+enum IMU_SchedPolicy {
+    IMU_SCHED_CATCH_UP = 0,
+    IMU_SCHED_SKIP = 1
+};
+
+struct IMU_Scheduler {
+    uint32_t period_us;         // Целая часть периода
+    uint8_t period_frac;        // Дробная часть периода (1/256 мкс)
+    uint8_t deadline_frac;
+    uint8_t policy;
+    bool started;
+    uint32_t deadline_us;       // Срок следующего отсчета
+    uint32_t last_us;           // Время последнего отсчета
+    uint64_t elapsed_us;        // Сумма интервалов между отсчетами (без переполнения micros)
+    uint32_t intervals;         // Число интервалов в elapsed_us
+    uint32_t ticks;             // Выдано отсчетов
+    uint32_t missed;            // Пропущено сроков
+    uint32_t max_late_us;       // Наибольшее запаздывание
+    uint16_t hist[IMU_SCHED_HIST_BINS]; // Гистограмма запаздывания
+};
+
+// Сводка работы планировщика
+struct IMU_SchedStats {
+    uint32_t ticks;             // Выдано отсчетов
+    uint32_t missed;            // Пропущено сроков (SKIP или отставание сверх IMU_SCHED_MAX_BACKLOG)
+    float rate_hz;              // Фактическая частота
+    uint32_t late_p50_us;       // Запаздывание относительно срока (верхняя граница корзины, не больше 65535)
+    uint32_t late_p90_us;
+    uint32_t late_p99_us;
+    uint32_t late_max_us;
+};
+
+/**
+ * @brief Настраивает планировщик на частоту frequency
+ * 
+ * @param s Планировщик
+ * @param frequency Частота (Гц), больше 0
+ * @param policy IMU_SCHED_CATCH_UP или IMU_SCHED_SKIP
+ * 
+ * Первый вызов IMU_schedDue() срабатывает сразу и задает начало сетки.
+ */
+void IMU_schedInit(IMU_Scheduler* s, float frequency, uint8_t policy);
+
+/**
+ * @brief Проверяет, наступил ли срок очередного отсчета
+ * 
+ * @return true — пора читать датчик; срок отмечен, следующий назначен
+ */
+bool IMU_schedDue(IMU_Scheduler* s);
+
+/**
+ * @brief То же, что IMU_schedDue(), с явным текущим временем (мкс)
+ */
+bool IMU_schedDueAt(IMU_Scheduler* s, uint32_t now_us);
+
+/**
+ * @brief Время до следующего срока (мкс); 0 — срок уже наступил
+ */
+uint32_t IMU_schedRemainingUs(const IMU_Scheduler* s);
+
+/**
+ * @brief Сводка: частота, пропуски, процентили запаздывания
+ */
+void IMU_schedStats(const IMU_Scheduler* s, IMU_SchedStats* st);
+
+/**
+ * @brief Сбрасывает статистику, не меняя сетку сроков
+ */
+void IMU_schedResetStats(IMU_Scheduler* s);
+
+#endif // IMU_SCHED_H
@@ -0,0 +1,256 @@
+/**
+ * @file IMU_Spectrum.cpp
+ * @brief Реализация потокового спектрального анализа вибрации
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Spectrum.h"
+
+#define N IMU_SPECTRUM_N
+#define M (IMU_SPECTRUM_N / 2)
+
+// Мощностное усиление окна Ханна (среднее w²) — поправка энергии
+#define HANN_POWER_GAIN 0.375f
+
+// Когерентное усиление окна Ханна (среднее w)
+#define HANN_COHERENT_GAIN 0.5f
+
+#if (N & (N - 1)) != 0 || N < 16 || N > 1024
+#error "IMU_SPECTRUM_N должно быть степенью двойки от 16 до 1024"
+#endif
+
+/**
+ * @brief Возвращает cos и sin угла 2πk/N (Q15) для k в [0, N/2]
+ */
+static void twiddle(const IMU_Spectrum* sp, uint16_t k, int16_t* c, int16_t* s) {
+    if (k <= N / 4) {
+        *s = sp->sin_tab[k];
+        *c = sp->sin_tab[N / 4 - k];
+    } else {
+        *s = sp->sin_tab[N / 2 - k];
+        *c = (int16_t)-sp->sin_tab[k - N / 4];
+    }
+}
+
+/**
+ * @brief Комплексное БПФ длины M на месте с масштабированием 1/2 на каждом этапе (итог 1/M)
+ */
+static void fft_complex(IMU_Spectrum* sp) {
+    int16_t* re = sp->re;
+    int16_t* im = sp->im;
+
+    // Перестановка с обратным порядком бит
+    for (uint16_t i = 1, j = 0; i < M; i++) {
+        uint16_t bit = M >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (uint16_t len = 2; len <= M; len <<= 1) {
+        uint16_t half = len >> 1;
+        uint16_t step = N / len; // W_len^j = W_N^(j * N / len)
+        for (uint16_t j = 0; j < half; j++) {
+            int16_t c, s;
+            twiddle(sp, j * step, &c, &s);
+            for (uint16_t a = j; a < M; a += len) {
+                uint16_t b = a + half;
+                // (re + j·im) * (c - j·s)
+                int16_t tr = (int16_t)(((int32_t)re[b] * c + (int32_t)im[b] * s) >> 15);
+                int16_t ti = (int16_t)(((int32_t)im[b] * c - (int32_t)re[b] * s) >> 15);
+                int16_t ar = re[a], ai = im[a];
+                re[a] = (int16_t)(((int32_t)ar + tr) >> 1);
+                im[a] = (int16_t)(((int32_t)ai + ti) >> 1);
+                re[b] = (int16_t)(((int32_t)ar - tr) >> 1);
+                im[b] = (int16_t)(((int32_t)ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Возвращает |X[k]|² вещественного БПФ длины N (X масштабирован на 1/N)
+ * 
+ * Восстанавливает бин k из комплексного БПФ половинной длины:
+ * X[k] = (Z[k] + Z*[M-k]) / 2 + W_N^k (Z[k] - Z*[M-k]) / 2j
+ */
+static uint32_t real_bin_power(const IMU_Spectrum* sp, uint16_t k) {
+    uint16_t kk = (k == 0) ? 0 : M - k;
+    int32_t ar = sp->re[k % M], ai = sp->im[k % M];
+    int32_t br = sp->re[kk], bi = -(int32_t)sp->im[kk];
+
+    int32_t er = (ar + br) >> 1, ei = (ai + bi) >> 1;
+    int32_t orr = (ai - bi) >> 1, oi = -((ar - br) >> 1);
+
+    int16_t c, s;
+    twiddle(sp, k, &c, &s);
+    int32_t xr = (er + ((c * orr + s * oi) >> 15)) >> 1;
+    int32_t xi = (ei + ((c * oi - s * orr) >> 15)) >> 1;
+    return (uint32_t)(xr * xr) + (uint32_t)(xi * xi);
+}
+
+/**
+ * @brief Анализирует последний блок оси a
+ */
+static void analyze_axis(IMU_Spectrum* sp, uint8_t a) {
+    const int16_t* in = sp->in[a];
+    IMU_SpectrumAxis* out = &sp->axis[a];
+
+    // Постоянная составляющая и СКЗ по блоку (от самого старого отсчета)
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < N; i++) {
+        sum += in[i];
+    }
+    int16_t mean = (int16_t)(sum / N);
+    // |d| ≤ 65535: квадрат помещается в uint32_t, сумма N квадратов — нет
+    uint64_t sq = 0;
+    for (uint16_t i = 0; i < N; i++) {
+        int32_t d = (int32_t)in[i] - mean;
+        uint32_t ad = (uint32_t)(d < 0 ? -d : d);
+        sq += ad * ad;
+    }
+    out->mean = (float)sum / N;
+    out->rms = sqrtf((float)sq / N);
+
+    // Окно и упаковка четных/нечетных отсчетов в комплексный буфер;
+    // Гёрцель работает по тем же взвешенным отсчетам
+    int32_t g1[IMU_SPECTRUM_GOERTZEL] = {0}, g2[IMU_SPECTRUM_GOERTZEL] = {0};
+    for (uint16_t n = 0; n < N; n++) {
+        int32_t d = (int32_t)in[(sp->pos + n) % N] - mean;
+        if (d > 32767) d = 32767;
+        if (d < -32768) d = -32768;
+        int16_t w = sp->window[n < M ? n : N - 1 - n];
+        int16_t x = (int16_t)((d * w) >> 15);
+        if (n & 1) {
+            sp->im[n >> 1] = x;
+        } else {
+            sp->re[n >> 1] = x;
+        }
+        for (uint8_t g = 0; g < sp->goertzels; g++) {
+            int32_t s0 = x + (int32_t)(((int64_t)sp->goertzel_coeff[g] * g1[g]) >> 14) - g2[g];
+            g2[g] = g1[g];
+            g1[g] = s0;
+        }
+    }
+
+    // Средний квадрат синуса амплитуды A в бине: 2|X|² = A²/2 (X масштабирован на 1/N),
+    // с поправкой на мощностное усиление окна
+    const float bin_scale = 2.0f / HANN_POWER_GAIN;
+
+    // Для Гёрцеля — поправка на когерентное усиление окна (0.5): оценивается
+    // амплитуда тона на заданной частоте, а не энергия полосы
+    const float tone_scale = 2.0f / (HANN_COHERENT_GAIN * HANN_COHERENT_GAIN);
+    for (uint8_t g = 0; g < sp->goertzels; g++) {
+        float s1 = (float)g1[g], s2 = (float)g2[g];
+        float coeff = sp->goertzel_coeff[g] / 16384.0f;
+        float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+        out->goertzel_ms[g] = power / ((float)N * N) * tone_scale;
+    }
+
+    fft_complex(sp);
+
+    float band[IMU_SPECTRUM_BANDS] = {0};
+    uint32_t peak = 0, prev = 0, peak_prev = 0, peak_next = 0;
+    uint16_t peak_k = 0;
+    for (uint16_t k = 1; k < M; k++) {
+        uint32_t p = real_bin_power(sp, k);
+        if (k == peak_k + 1) {
+            peak_next = p;
+        }
+        if (p > peak) {
+            peak = p;
+            peak_k = k;
+            peak_prev = prev;
+            peak_next = 0;
+        }
+        for (uint8_t b = 0; b < sp->bands; b++) {
+            if (k >= sp->band_lo[b] && k <= sp->band_hi[b]) {
+                band[b] += (float)p;
+            }
+        }
+        prev = p;
+    }
+
+    // Уточнение частоты пика параболой по соседним бинам
+    float delta = 0.0f;
+    float denom = (float)peak_prev - 2.0f * peak + (float)peak_next;
+    if (peak_k > 0 && denom < 0.0f) {
+        delta = 0.5f * ((float)peak_prev - (float)peak_next) / denom;
+    }
+    out->peak_hz = (peak_k + delta) * sp->sample_hz / N;
+    // Энергия синуса растекается окном Ханна на соседние бины — учитываем их
+    out->peak_ms = ((float)peak + peak_prev + peak_next) * bin_scale;
+    for (uint8_t b = 0; b < sp->bands; b++) {
+        out->band_ms[b] = band[b] * bin_scale;
+    }
+}
+
+void IMU_spectrumInit(IMU_Spectrum* sp, float sample_hz, uint16_t hop) {
+    memset(sp, 0, sizeof(*sp));
+    sp->sample_hz = sample_hz;
+    sp->hop = (hop == 0 || hop > N) ? N / 2 : hop;
+
+    for (uint16_t i = 0; i <= N / 4; i++) {
+        sp->sin_tab[i] = (int16_t)lroundf(32767.0f * sinf(2.0f * (float)M_PI * i / N));
+    }
+    for (uint16_t i = 0; i < M; i++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (N - 1));
+        sp->window[i] = (int16_t)lroundf(32767.0f * w);
+    }
+}
+
+bool IMU_spectrumAddBand(IMU_Spectrum* sp, float lo_hz, float hi_hz) {
+    if (sp->bands >= IMU_SPECTRUM_BANDS) {
+        return false;
+    }
+    float bin_hz = sp->sample_hz / N;
+    long lo = lroundf(lo_hz / bin_hz), hi = lroundf(hi_hz / bin_hz);
+    sp->band_lo[sp->bands] = (uint16_t)(lo < 1 ? 1 : lo);
+    sp->band_hi[sp->bands] = (uint16_t)(hi > M - 1 ? M - 1 : hi);
+    sp->bands++;
+    return true;
+}
+
+bool IMU_spectrumAddFrequency(IMU_Spectrum* sp, float hz) {
+    if (sp->goertzels >= IMU_SPECTRUM_GOERTZEL) {
+        return false;
+    }
+    float w = 2.0f * (float)M_PI * hz / sp->sample_hz;
+    sp->goertzel_coeff[sp->goertzels++] = (int16_t)lroundf(2.0f * cosf(w) * 16383.0f);
+    return true;
+}
+
+bool IMU_spectrumPush(IMU_Spectrum* sp, const int16_t* acc) {
+    sp->in[0][sp->pos] = acc[0];
+    sp->in[1][sp->pos] = acc[1];
+    sp->in[2][sp->pos] = acc[2];
+    sp->pos = (sp->pos + 1) % N;
+    if (sp->filled < N) {
+        sp->filled++;
+    }
+    sp->since++;
+
+    if (sp->filled < N || sp->since < sp->hop) {
+        return false;
+    }
+    sp->since = 0;
+    for (uint8_t a = 0; a < 3; a++) {
+        analyze_axis(sp, a);
+    }
+    sp->blocks++;
+    return true;
+}
+
+float IMU_spectrumBinHz(const IMU_Spectrum* sp, uint16_t k) {
+    return k * sp->sample_hz / N;
+}
+
+#undef N
+#undef M
@@ -0,0 +1,120 @@
+/**
+ * @file IMU_Spectrum.h
+ * @brief Потоковый спектральный анализ вибрации по каналам акселерометра
+ * 
+ * Модуль принимает отсчеты акселерометра с полной частотой датчика
+ * (до 1600 Гц) и по скользящим блокам из IMU_SPECTRUM_N отсчетов вычисляет
+ * для каждой оси:
+ * - СКЗ переменной составляющей (RMS) и постоянную составляющую
+ * - энергию в заданных полосах частот
+ * - частоту и энергию наибольшего пика спектра
+ * - энергию на выбранных частотах (алгоритм Гёрцеля)
+ * 
+ * Вычисления: окно Ханна и вещественное БПФ в фиксированной точке Q15
+ * (комплексное БПФ половинной длины с масштабированием 1/2 на каждом этапе,
+ * переполнение исключено). Энергии приводятся к среднему квадрату в LSB²
+ * с учетом потерь окна, т.е. синус амплитуды A дает в своей полосе A²/2.
+ * 
+ * Память: 3 * IMU_SPECTRUM_N * 2 байт входных буферов + IMU_SPECTRUM_N * 2 байт
+ * рабочего буфера + таблицы (≈ 1.2 КБ при N = 128). Предназначен для
+ * 32-битных микроконтроллеров; на AVR используйте N = 32-64 и низкую частоту.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_SPECTRUM_H
+#define IMU_SPECTRUM_H
+
+#include <Arduino.h>
+
+// Длина блока БПФ (степень двойки, 16-1024)
+#ifndef IMU_SPECTRUM_N
+#define IMU_SPECTRUM_N 128
+#endif
+
+// Максимальное количество полос частот
+#ifndef IMU_SPECTRUM_BANDS
+#define IMU_SPECTRUM_BANDS 4
+#endif
+
+// Максимальное количество частот Гёрцеля
+#ifndef IMU_SPECTRUM_GOERTZEL
+#define IMU_SPECTRUM_GOERTZEL 4
+#endif
+
+// Результаты анализа одной оси за блок
+struct IMU_SpectrumAxis {
+    float mean;                               // Постоянная составляющая (LSB)
+    float rms;                                // СКЗ переменной составляющей (LSB)
+    float peak_hz;                            // Частота наибольшего пика (Гц)
+    float peak_ms;                            // Энергия пика (средний квадрат, LSB²)
+    float band_ms[IMU_SPECTRUM_BANDS];        // Энергия в полосах (средний квадрат, LSB²)
+    float goertzel_ms[IMU_SPECTRUM_GOERTZEL]; // Средний квадрат тона на частотах Гёрцеля (LSB²)
+};
+
+struct IMU_Spectrum {
+    // Конфигурация
+    float sample_hz;                          // Частота отсчетов
+    uint16_t hop;                             // Сдвиг блока (отсчетов)
+    uint8_t bands;                            // Количество полос
+    uint16_t band_lo[IMU_SPECTRUM_BANDS];     // Границы полос (номера бинов, включительно)
+    uint16_t band_hi[IMU_SPECTRUM_BANDS];
+    uint8_t goertzels;                        // Количество частот Гёрцеля
+    int16_t goertzel_coeff[IMU_SPECTRUM_GOERTZEL]; // 2cos(ω) в Q14
+
+    // Таблицы
+    int16_t sin_tab[IMU_SPECTRUM_N / 4 + 1];  // sin(2πi/N), Q15
+    int16_t window[IMU_SPECTRUM_N / 2];       // Половина окна Ханна, Q15
+
+    // Входные данные
+    int16_t in[3][IMU_SPECTRUM_N];            // Кольцевые буферы осей
+    uint16_t pos;                             // Позиция записи
+    uint16_t filled;                          // Заполнено отсчетов (до N)
+    uint16_t since;                           // Отсчетов с последнего анализа
+
+    // Рабочий буфер БПФ (N/2 комплексных значений)
+    int16_t re[IMU_SPECTRUM_N / 2];
+    int16_t im[IMU_SPECTRUM_N / 2];
+
+    // Результаты
+    IMU_SpectrumAxis axis[3];
+    uint32_t blocks;                          // Проанализировано блоков
+};
+
+/**
+ * @brief Инициализирует анализатор
+ * 
+ * @param sp Состояние
+ * @param sample_hz Частота подачи отсчетов (обычно ODR акселерометра)
+ * @param hop Сдвиг между блоками в отсчетах (N/2 — перекрытие 50%, N — без перекрытия)
+ */
+void IMU_spectrumInit(IMU_Spectrum* sp, float sample_hz, uint16_t hop);
+
+/**
+ * @brief Добавляет полосу частот [lo_hz, hi_hz] для расчета энергии
+ * 
+ * @return false если полос уже IMU_SPECTRUM_BANDS
+ */
+bool IMU_spectrumAddBand(IMU_Spectrum* sp, float lo_hz, float hi_hz);
+
+/**
+ * @brief Добавляет частоту для расчета энергии алгоритмом Гёрцеля
+ * 
+ * @return false если частот уже IMU_SPECTRUM_GOERTZEL
+ */
+bool IMU_spectrumAddFrequency(IMU_Spectrum* sp, float hz);
+
+/**
+ * @brief Подает отсчет акселерометра (x, y, z)
+ * 
+ * @return true если по завершенному блоку получены новые результаты (sp->axis)
+ */
+bool IMU_spectrumPush(IMU_Spectrum* sp, const int16_t* acc);
+
+/**
+ * @brief Возвращает частоту бина k (Гц)
+ */
+float IMU_spectrumBinHz(const IMU_Spectrum* sp, uint16_t k);
+
+#endif // IMU_SPECTRUM_H
@@ -0,0 +1,178 @@
+/**
+ * @file IMU_Stats.cpp
+ * @brief Реализация оконной потоковой статистики
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_Stats.h"
+
+/**
+ * @brief Раскладывает 9 осей отсчета в массив
+ */
+static void sample_axes(const IMU_Sample* s, int16_t* v) {
+    v[0] = s->acc[0]; v[1] = s->acc[1]; v[2] = s->acc[2];
+    v[3] = s->gyr[0]; v[4] = s->gyr[1]; v[5] = s->gyr[2];
+    v[6] = s->mag[0]; v[7] = s->mag[1]; v[8] = s->mag[2];
+}
+
+/**
+ * @brief Переводит целочисленные суммы текущей части в сводку (n, среднее, M2)
+ */
+static void close_pane(IMU_Stats* st, IMU_StatsPane* p) {
+    p->n = st->n;
+    for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+        // M2 = Σd² - (Σd)² / n — точно в целых (|Σd| < 2^31, n ≤ 32767)
+        int64_t sum = st->sum[c];
+        int64_t m2 = (int64_t)st->sumsq[c] - (sum * sum) / st->n;
+        p->mean[c] = st->offset[c] + (float)sum / st->n;
+        p->m2[c] = (float)m2;
+        p->min[c] = st->min[c];
+        p->max[c] = st->max[c];
+    }
+}
+
+/**
+ * @brief Объединяет части окна и формирует сводку
+ */
+static void build_result(IMU_Stats* st, uint32_t t_end_us) {
+    IMU_StatsWindow* w = &st->result;
+    uint8_t first = (uint8_t)((st->ring_head + IMU_STATS_PANES - st->ring_count) % IMU_STATS_PANES);
+
+    float n = 0;
+    for (uint8_t k = 0; k < st->ring_count; k++) {
+        uint8_t i = (uint8_t)((first + k) % IMU_STATS_PANES);
+        const IMU_StatsPane* p = &st->ring[i];
+        float nb = p->n;
+        float nn = n + nb;
+        for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+            if (k == 0) {
+                w->mean[c] = p->mean[c];
+                w->var[c] = p->m2[c];  // временно хранит M2
+                w->min[c] = p->min[c];
+                w->max[c] = p->max[c];
+                continue;
+            }
+            // Объединение по Чану: δ = μb - μa, μ = μa + δ·nb/n, M2 = M2a + M2b + δ²·na·nb/n
+            float delta = p->mean[c] - w->mean[c];
+            w->mean[c] += delta * nb / nn;
+            w->var[c] += p->m2[c] + delta * delta * n * nb / nn;
+            if (p->min[c] < w->min[c]) w->min[c] = p->min[c];
+            if (p->max[c] > w->max[c]) w->max[c] = p->max[c];
+        }
+        n = nn;
+    }
+
+    for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+        float m2 = w->var[c] > 0 ? w->var[c] : 0;
+        w->var[c] = n > 1 ? m2 / (n - 1) : 0;
+        w->std[c] = sqrtf(w->var[c]);
+        w->rms[c] = sqrtf(m2 / n + w->mean[c] * w->mean[c]);
+        w->p2p[c] = (uint16_t)(w->max[c] - w->min[c]);
+    }
+    w->n = (uint32_t)n;
+    w->t_start_us = st->ring_t_start[first];
+    w->t_end_us = t_end_us;
+    st->windows++;
+}
+
+bool IMU_statsInit(IMU_Stats* st, uint32_t window, uint8_t panes) {
+    memset(st, 0, sizeof(*st));
+    if (panes == 0 || panes > IMU_STATS_PANES || window < panes) {
+        return false;
+    }
+    uint32_t pane_len = window / panes;
+    if (pane_len > IMU_STATS_MAX_PANE) {
+        return false;
+    }
+    st->pane_len = (uint16_t)pane_len;
+    st->panes = panes;
+    return true;
+}
+
+bool IMU_statsPush(IMU_Stats* st, const IMU_Sample* s) {
+    if (st->pane_len == 0) {
+        return false;
+    }
+
+    int16_t v[IMU_STATS_CHANNELS];
+    sample_axes(s, v);
+
+    if (st->n == 0) {
+        st->t_first_us = s->t_us;
+        for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+            st->offset[c] = v[c];
+            st->sum[c] = 0;
+            st->sumsq[c] = 0;
+            st->min[c] = v[c];
+            st->max[c] = v[c];
+        }
+    }
+
+    // Целочисленный путь: отклонение от первого отсчета части, d² < 2^32
+    for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+        int32_t d = (int32_t)v[c] - st->offset[c];
+        st->sum[c] += d;
+        uint32_t ad = (uint32_t)(d < 0 ? -d : d);
+        st->sumsq[c] += ad * ad;
+        if (v[c] < st->min[c]) st->min[c] = v[c];
+        if (v[c] > st->max[c]) st->max[c] = v[c];
+    }
+    st->n++;
+
+    if (st->n < st->pane_len) {
+        return false;
+    }
+
+    close_pane(st, &st->ring[st->ring_head]);
+    st->ring_t_start[st->ring_head] = st->t_first_us;
+    st->ring_head = (uint8_t)((st->ring_head + 1) % IMU_STATS_PANES);
+    if (st->ring_count < st->panes) {
+        st->ring_count++;
+    }
+    st->n = 0;
+
+    if (st->ring_count < st->panes) {
+        return false;
+    }
+    build_result(st, s->t_us);
+    if (st->panes == 1) {
+        st->ring_count = 0;
+    }
+    return true;
+}
+
+const IMU_StatsWindow* IMU_statsResult(const IMU_Stats* st) {
+    return &st->result;
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t sat_u16(float v) {
+    if (v <= 0) return 0;
+    if (v >= 65535.0f) return 65535;
+    return (uint16_t)(v + 0.5f);
+}
+
+size_t IMU_statsPack(const IMU_StatsWindow* w, uint8_t* out) {
+    uint8_t* p = out;
+    p[0] = (uint8_t)w->t_end_us;
+    p[1] = (uint8_t)(w->t_end_us >> 8);
+    p[2] = (uint8_t)(w->t_end_us >> 16);
+    p[3] = (uint8_t)(w->t_end_us >> 24);
+    put_u16(&p[4], w->n > 65535 ? 65535 : (uint16_t)w->n);
+    p += 6;
+    for (uint8_t c = 0; c < IMU_STATS_CHANNELS; c++) {
+        put_u16(&p[0], (uint16_t)(int16_t)lroundf(w->mean[c]));
+        put_u16(&p[2], sat_u16(w->std[c] * 16.0f));
+        put_u16(&p[4], sat_u16(w->rms[c]));
+        put_u16(&p[6], (uint16_t)w->min[c]);
+        put_u16(&p[8], (uint16_t)w->max[c]);
+        p += 10;
+    }
+    return (size_t)(p - out);
+}
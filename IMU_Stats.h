@@ -0,0 +1,130 @@
+/**
+ * @file IMU_Stats.h
+ * @brief Оконная потоковая статистика каналов IMU для сокращения телеметрии
+ * 
+ * Вместо передачи каждого отсчета модуль считает по окну для каждой из 9 осей
+ * (acc, gyr, mag) среднее, дисперсию, СКО, минимум, максимум, СКЗ (RMS)
+ * и размах, и выдает одну сводку на окно.
+ * 
+ * Окна:
+ * - Неперекрывающиеся (tumbling): panes = 1, сводка каждые window отсчетов
+ * - Скользящие (sliding): окно делится на panes частей, сводка по последним
+ *   panes частям выдается после каждой части (каждые window / panes отсчетов)
+ * 
+ * Память постоянна и не зависит от длины окна: текущая часть и сводки
+ * IMU_STATS_PANES частей.
+ * 
+ * Вычисления:
+ * - На каждом отсчете — только целочисленные операции: сумма и сумма квадратов
+ *   отклонений от первого отсчета части (точные, без потери точности на
+ *   большом постоянном смещении, например 1g по оси Z)
+ * - При закрытии части — перевод в (n, среднее, M2) и объединение частей
+ *   по формулам Велфорда/Чана
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_STATS_H
+#define IMU_STATS_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Количество осей: acc x/y/z, gyr x/y/z, mag x/y/z
+#define IMU_STATS_CHANNELS 9
+
+// Максимальное количество частей скользящего окна
+#ifndef IMU_STATS_PANES
+#define IMU_STATS_PANES 4
+#endif
+
+// Максимальная длина части окна (отсчетов): ограничивает разрядность промежуточных сумм
+#define IMU_STATS_MAX_PANE 32767
+
+// Размер упакованной сводки IMU_statsPack() (байт)
+#define IMU_STATS_PACKED_SIZE (4 + 2 + IMU_STATS_CHANNELS * 10)
+
+// Сводка части окна
+struct IMU_StatsPane {
+    uint16_t n;
+    float mean[IMU_STATS_CHANNELS];
+    float m2[IMU_STATS_CHANNELS];   // Сумма квадратов отклонений от среднего
+    int16_t min[IMU_STATS_CHANNELS];
+    int16_t max[IMU_STATS_CHANNELS];
+};
+
+// Статистика окна
+struct IMU_StatsWindow {
+    uint32_t t_start_us;                  // Время первого отсчета окна
+    uint32_t t_end_us;                    // Время последнего отсчета окна
+    uint32_t n;                           // Отсчетов в окне
+    float mean[IMU_STATS_CHANNELS];
+    float var[IMU_STATS_CHANNELS];        // Выборочная дисперсия (n - 1)
+    float std[IMU_STATS_CHANNELS];        // Выборочное СКО
+    float rms[IMU_STATS_CHANNELS];        // СКЗ (включая постоянную составляющую)
+    int16_t min[IMU_STATS_CHANNELS];
+    int16_t max[IMU_STATS_CHANNELS];
+    uint16_t p2p[IMU_STATS_CHANNELS];     // Размах (max - min)
+};
+
+struct IMU_Stats {
+    uint16_t pane_len;                    // Отсчетов в части
+    uint8_t panes;                        // Частей в окне (1 — неперекрывающиеся окна)
+
+    // Текущая часть: целочисленные суммы отклонений от первого отсчета
+    uint16_t n;
+    int16_t offset[IMU_STATS_CHANNELS];
+    int32_t sum[IMU_STATS_CHANNELS];
+    uint64_t sumsq[IMU_STATS_CHANNELS];
+    int16_t min[IMU_STATS_CHANNELS];
+    int16_t max[IMU_STATS_CHANNELS];
+    uint32_t t_first_us;
+
+    // Закрытые части (кольцо)
+    IMU_StatsPane ring[IMU_STATS_PANES];
+    uint32_t ring_t_start[IMU_STATS_PANES];
+    uint8_t ring_head;                    // Позиция следующей части
+    uint8_t ring_count;                   // Заполнено частей
+
+    IMU_StatsWindow result;               // Последняя сводка
+    uint32_t windows;                     // Выдано сводок
+};
+
+/**
+ * @brief Инициализирует статистику
+ * 
+ * @param st Состояние
+ * @param window Длина окна (отсчетов)
+ * @param panes 1 — неперекрывающиеся окна; 2..IMU_STATS_PANES — скользящее окно
+ *              с шагом window / panes
+ * @return false если параметры недопустимы (часть окна длиннее IMU_STATS_MAX_PANE и т.п.)
+ */
+bool IMU_statsInit(IMU_Stats* st, uint32_t window, uint8_t panes);
+
+/**
+ * @brief Добавляет отсчет
+ * 
+ * @return true если готова новая сводка (IMU_statsResult)
+ */
+bool IMU_statsPush(IMU_Stats* st, const IMU_Sample* s);
+
+/**
+ * @brief Возвращает последнюю сводку
+ */
+const IMU_StatsWindow* IMU_statsResult(const IMU_Stats* st);
+
+/**
+ * @brief Упаковывает сводку в компактную запись для передачи
+ * 
+ * @param w Сводка
+ * @param out Буфер не меньше IMU_STATS_PACKED_SIZE байт
+ * @return Размер записи (IMU_STATS_PACKED_SIZE)
+ * 
+ * Формат (little-endian): t_end_us (4), n (2, насыщение на 65535),
+ * затем для каждой оси: mean (int16, LSB), std (uint16, 1/16 LSB, насыщение),
+ * rms (uint16, LSB), min (int16), max (int16). Размах = max - min.
+ */
+size_t IMU_statsPack(const IMU_StatsWindow* w, uint8_t* out);
+
+#endif // IMU_STATS_H
@@ -0,0 +1,179 @@
+/**
+ * @file IMU_TempBias.cpp
+ * @brief Реализация модели смещения нуля гироскопа по температуре
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include "IMU_TempBias.h"
+
+/**
+ * @brief Положение температуры в таблице: индекс интервала и доля (0..255) до следующего
+ */
+static void locate(const IMU_TempBias* tb, int16_t temp_raw, uint8_t* idx, uint8_t* frac) {
+    int32_t rel = (int32_t)temp_raw - tb->t_min_raw;
+    int32_t span = (int32_t)tb->bin_raw * (IMU_TEMPBIAS_BINS - 1);
+    if (rel <= 0) {
+        *idx = 0;
+        *frac = 0;
+        return;
+    }
+    if (rel >= span) {
+        *idx = IMU_TEMPBIAS_BINS - 1;
+        *frac = 0;
+        return;
+    }
+    int32_t pos = (rel * 256) / tb->bin_raw;
+    *idx = (uint8_t)(pos >> 8);
+    *frac = (uint8_t)(pos & 0xFF);
+}
+
+/**
+ * @brief Добавляет наблюдение в интервал с весом w (1/256 наблюдения)
+ */
+static void learn_bin(IMU_TempBiasBin* bin, const int16_t* obs_q4, uint16_t w) {
+    if (w == 0) {
+        return;
+    }
+    uint32_t total = (uint32_t)bin->weight + w;
+    for (uint8_t i = 0; i < 3; i++) {
+        int32_t diff = (int32_t)obs_q4[i] - bin->bias_q4[i];
+        bin->bias_q4[i] = (int16_t)(bin->bias_q4[i] + diff * (int32_t)w / (int32_t)total);
+    }
+    const uint32_t cap = (uint32_t)IMU_TEMPBIAS_MAX_WEIGHT * 256;
+    bin->weight = (uint16_t)(total > cap ? cap : total);
+}
+
+/**
+ * @brief Ближайший обученный интервал к idx (или -1)
+ */
+static int nearest_learned(const IMU_TempBias* tb, uint8_t idx) {
+    for (uint8_t d = 0; d < IMU_TEMPBIAS_BINS; d++) {
+        if (idx >= d && tb->bins[idx - d].weight) return idx - d;
+        if (idx + d < IMU_TEMPBIAS_BINS && tb->bins[idx + d].weight) return idx + d;
+    }
+    return -1;
+}
+
+static void reset_window(IMU_TempBias* tb) {
+    tb->n = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        tb->gsum[i] = 0;
+    }
+    tb->tsum = 0;
+}
+
+void IMU_tempBiasInit(IMU_TempBias* tb, float t_min_c, float t_max_c) {
+    memset(tb, 0, sizeof(*tb));
+    if (t_max_c <= t_min_c) {
+        t_max_c = t_min_c + IMU_TEMPBIAS_BINS - 1;
+    }
+    tb->t_min_raw = (int16_t)((t_min_c - 23.0f) * 512.0f);
+    float bin = (t_max_c - t_min_c) / (IMU_TEMPBIAS_BINS - 1) * 512.0f;
+    tb->bin_raw = (int16_t)(bin < 1 ? 1 : bin);
+    tb->gyr_pp_max = (int16_t)(1.0f * GYR_LSB);
+    tb->acc_pp_max = (int16_t)(0.02f * ACC_LSB);
+    reset_window(tb);
+}
+
+void IMU_tempBiasUpdate(IMU_TempBias* tb, const int16_t* acc, const int16_t* gyr, int16_t temp_raw) {
+    if (temp_raw == IMU_TEMP_INVALID) {
+        reset_window(tb);
+        return;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        if (tb->n == 0) {
+            tb->gmin[i] = tb->gmax[i] = gyr[i];
+            tb->amin[i] = tb->amax[i] = acc[i];
+        }
+        if (gyr[i] < tb->gmin[i]) tb->gmin[i] = gyr[i];
+        if (gyr[i] > tb->gmax[i]) tb->gmax[i] = gyr[i];
+        if (acc[i] < tb->amin[i]) tb->amin[i] = acc[i];
+        if (acc[i] > tb->amax[i]) tb->amax[i] = acc[i];
+        tb->gsum[i] += gyr[i];
+    }
+    tb->tsum += temp_raw;
+    if (++tb->n < IMU_TEMPBIAS_WINDOW) {
+        return;
+    }
+
+    bool still = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        if ((int32_t)tb->gmax[i] - tb->gmin[i] > tb->gyr_pp_max ||
+            (int32_t)tb->amax[i] - tb->amin[i] > tb->acc_pp_max) {
+            still = false;
+        }
+    }
+    tb->stationary = still;
+
+    if (still) {
+        int16_t obs_q4[3];
+        for (uint8_t i = 0; i < 3; i++) {
+            int32_t s = tb->gsum[i] * 16;
+            obs_q4[i] = (int16_t)((s >= 0 ? s + IMU_TEMPBIAS_WINDOW / 2 : s - IMU_TEMPBIAS_WINDOW / 2) / IMU_TEMPBIAS_WINDOW);
+        }
+        int16_t t_mean = (int16_t)(tb->tsum / IMU_TEMPBIAS_WINDOW);
+        uint8_t idx, frac;
+        locate(tb, t_mean, &idx, &frac);
+        // Наблюдение распределяется между соседними интервалами по положению температуры
+        learn_bin(&tb->bins[idx], obs_q4, (uint16_t)(256 - frac));
+        if (idx + 1 < IMU_TEMPBIAS_BINS) {
+            learn_bin(&tb->bins[idx + 1], obs_q4, frac);
+        }
+        tb->updates++;
+        tb->cache_valid = false;
+    }
+    reset_window(tb);
+}
+
+bool IMU_tempBiasAt(IMU_TempBias* tb, int16_t temp_raw, int16_t* bias_q4) {
+    if (temp_raw == IMU_TEMP_INVALID) {
+        return false;
+    }
+    if (tb->cache_valid && tb->cached_temp == temp_raw) {
+        memcpy(bias_q4, tb->cached_q4, sizeof(tb->cached_q4));
+        return true;
+    }
+
+    uint8_t idx, frac;
+    locate(tb, temp_raw, &idx, &frac);
+    const IMU_TempBiasBin* a = &tb->bins[idx];
+    const IMU_TempBiasBin* b = idx + 1 < IMU_TEMPBIAS_BINS ? &tb->bins[idx + 1] : a;
+    if (a->weight && b->weight) {
+        for (uint8_t i = 0; i < 3; i++) {
+            int32_t d = (int32_t)b->bias_q4[i] - a->bias_q4[i];
+            bias_q4[i] = (int16_t)(a->bias_q4[i] + d * frac / 256);
+        }
+    } else {
+        // Вне обученного диапазона — ближайший обученный интервал
+        int k = nearest_learned(tb, a->weight || !b->weight ? idx : (uint8_t)(idx + 1));
+        if (k < 0) {
+            return false;
+        }
+        memcpy(bias_q4, tb->bins[k].bias_q4, sizeof(tb->bins[k].bias_q4));
+    }
+
+    tb->cached_temp = temp_raw;
+    memcpy(tb->cached_q4, bias_q4, sizeof(tb->cached_q4));
+    tb->cache_valid = true;
+    return true;
+}
+
+bool IMU_tempBiasApply(IMU_TempBias* tb, int16_t* gyr, int16_t temp_raw) {
+    int16_t q4[3];
+    if (!IMU_tempBiasAt(tb, temp_raw, q4)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        int32_t v = (int32_t)gyr[i] - ((q4[i] + 8) >> 4);
+        gyr[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+    return true;
+}
+
+bool IMU_tempBiasProcess(IMU_TempBias* tb, const int16_t* acc, int16_t* gyr) {
+    int16_t t = IMU_getTemperatureRaw();
+    IMU_tempBiasUpdate(tb, acc, gyr, t);
+    return IMU_tempBiasApply(tb, gyr, t);
+}
@@ -0,0 +1,121 @@
+/**
+ * @file IMU_TempBias.h
+ * @brief Модель смещения нуля гироскопа по температуре, обучаемая в неподвижности
+ * 
+ * Смещение нуля гироскопа меняется при прогреве корпуса. Модуль хранит
+ * компактную таблицу смещения по интервалам температуры BMI160 и дообучает
+ * ее всякий раз, когда устройство неподвижно: среднее гироскопа за окно
+ * IMU_TEMPBIAS_WINDOW отсчетов без движения — наблюдение смещения при
+ * текущей температуре. Каждый отсчет исправляется линейной интерполяцией
+ * по таблице — без пауз на перекалибровку и без тяжелого фильтра.
+ * 
+ * Неподвижность: размах каждой оси гироскопа и акселерометра за окно
+ * не превышает порога (по умолчанию 1 °/s и 0.02 g).
+ * 
+ * Стоимость на отсчет: сравнения и сложения в целых; интерполяция
+ * пересчитывается только при изменении температуры.
+ * 
+ * Пример:
+ * @code
+ * IMU_TempBias tb;
+ * IMU_tempBiasInit(&tb, -10.0f, 70.0f);
+ * 
+ * IMU_readChannels(IMU_CHANNEL_ACC | IMU_CHANNEL_GYR | IMU_CHANNEL_TEMP, acc, gyr, nullptr, nullptr);
+ * IMU_tempBiasProcess(&tb, acc, gyr);  // обучение + вычитание смещения из gyr
+ * @endcode
+ * 
+ * Таблица (поле bins) — обычные данные: ее можно сохранить в EEPROM
+ * и восстановить после перезапуска.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_TEMPBIAS_H
+#define IMU_TEMPBIAS_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+// Количество интервалов температуры
+#ifndef IMU_TEMPBIAS_BINS
+#define IMU_TEMPBIAS_BINS 16
+#endif
+
+// Длина окна проверки неподвижности (отсчетов)
+#ifndef IMU_TEMPBIAS_WINDOW
+#define IMU_TEMPBIAS_WINDOW 32
+#endif
+
+// Наибольший вес интервала (в наблюдениях): дальше таблица следует
+// за смещением как экспоненциальное среднее с весом 1/N
+#ifndef IMU_TEMPBIAS_MAX_WEIGHT
+#define IMU_TEMPBIAS_MAX_WEIGHT 16
+#endif
+
+// Смещение в интервале температуры
+struct IMU_TempBiasBin {
+    int16_t bias_q4[3];     // Смещение гироскопа (LSB × 16)
+    uint16_t weight;        // Накопленный вес (наблюдений × 256); 0 — не обучен
+};
+
+struct IMU_TempBias {
+    IMU_TempBiasBin bins[IMU_TEMPBIAS_BINS];
+    int16_t t_min_raw;      // Температура начала таблицы (сырые единицы BMI160)
+    int16_t bin_raw;        // Ширина интервала (сырые единицы)
+    int16_t gyr_pp_max;     // Порог размаха гироскопа за окно (LSB)
+    int16_t acc_pp_max;     // Порог размаха акселерометра за окно (LSB)
+
+    // Текущее окно проверки неподвижности
+    uint8_t n;
+    int16_t gmin[3], gmax[3], amin[3], amax[3];
+    int32_t gsum[3];
+    int32_t tsum;
+    bool stationary;        // Последнее окно было неподвижным
+    uint32_t updates;       // Принято наблюдений
+
+    // Кэш поправки для последней температуры
+    int16_t cached_temp;
+    int16_t cached_q4[3];
+    bool cache_valid;
+};
+
+/**
+ * @brief Инициализирует пустую таблицу
+ * 
+ * @param tb Модель
+ * @param t_min_c Нижняя граница таблицы (°C)
+ * @param t_max_c Верхняя граница таблицы (°C)
+ * 
+ * Пороги неподвижности пересчитываются по текущим ACC_LSB и GYR_LSB:
+ * вызывайте после IMU_begin() и после смены диапазона.
+ */
+void IMU_tempBiasInit(IMU_TempBias* tb, float t_min_c, float t_max_c);
+
+/**
+ * @brief Обучение: добавляет отсчет в окно проверки неподвижности
+ * 
+ * @param acc Акселерометр (LSB)
+ * @param gyr Гироскоп (LSB) — до вычитания смещения
+ * @param temp_raw Температура (IMU_getTemperatureRaw)
+ */
+void IMU_tempBiasUpdate(IMU_TempBias* tb, const int16_t* acc, const int16_t* gyr, int16_t temp_raw);
+
+/**
+ * @brief Вычитает смещение при температуре temp_raw из gyr
+ * 
+ * @return false если таблица еще пуста или температура недействительна (gyr не изменен)
+ */
+bool IMU_tempBiasApply(IMU_TempBias* tb, int16_t* gyr, int16_t temp_raw);
+
+/**
+ * @brief Обучение и поправка одним вызовом с температурой из IMU_getTemperatureRaw()
+ */
+bool IMU_tempBiasProcess(IMU_TempBias* tb, const int16_t* acc, int16_t* gyr);
+
+/**
+ * @brief Смещение при температуре (LSB × 16) без изменения отсчета
+ */
+bool IMU_tempBiasAt(IMU_TempBias* tb, int16_t temp_raw, int16_t* bias_q4);
+
+#endif // IMU_TEMPBIAS_H
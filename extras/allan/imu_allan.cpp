@@ -0,0 +1,388 @@
+/**
+ * @file imu_allan.cpp
+ * @brief Девиация Аллана и шумовые параметры акселерометра и гироскопа по журналу IMU
+ * 
+ * Читает журнал IMU_LogCodec (неподвижный датчик, часы записи), вычисляет
+ * перекрывающуюся девиацию Аллана для acc x/y/z и gyr x/y/z и оценивает
+ * по каждой оси:
+ * - плотность белого шума / случайное блуждание (ARW, VRW) — участок наклона -1/2
+ * - нестабильность нуля — минимум кривой / 0.664
+ * - случайное блуждание скорости (RRW) — участок наклона +1/2
+ * 
+ * Кривая выводится в stdout в формате TSV (tau, 6 осей в физических единицах),
+ * параметры и время выполнения — в stderr.
+ * 
+ * Обработка рассчитана на журналы в несколько гигабайт:
+ * - файл отображается в память (mmap), блоки журнала независимы и
+ *   декодируются параллельно в столбцы int16 по осям
+ * - для каждой оси строится целочисленная накопленная сумма θ (int64, точно),
+ *   после чего σ²(m) считается одним последовательным проходом по трем
+ *   потокам θ[k], θ[k+m], θ[k+2m]; диапазон k делится на части между потоками
+ * - в памяти одновременно находятся столбцы int16 и θ только одной оси
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++17 -I extras/host -I . IMU_LogCodec.cpp \
+ *       extras/host/host_arduino.cpp extras/allan/imu_allan.cpp -o imu_allan -lpthread
+ * 
+ * Использование:
+ *   ./imu_allan log.bin [--block 512] [--acc-g 4] [--gyr-dps 2000] [--threads N] > adev.tsv
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_LogCodec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Осей в анализе: acc x/y/z, gyr x/y/z
+static const int AXES = 6;
+
+// Точек кривой на декаду tau
+static const int POINTS_PER_DECADE = 10;
+
+// Отсчетов k на одно задание при вычислении σ²(m)
+static const size_t CHUNK = 1 << 20;
+
+static const char* const axis_names[AXES] = { "acc_x", "acc_y", "acc_z", "gyr_x", "gyr_y", "gyr_z" };
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Запускает fn(worker) в threads потоках и дожидается завершения
+ */
+template <typename Fn>
+static void parallel(unsigned threads, Fn fn) {
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < threads; w++) {
+        pool.emplace_back(fn, w);
+    }
+    fn(0u);
+    for (auto& t : pool) {
+        t.join();
+    }
+}
+
+// Сведения о блоке после первого прохода
+struct BlockMeta {
+    size_t first;       // Индекс первого отсчета в столбцах
+    uint32_t count;     // Отсчетов (0 — блок поврежден)
+    uint32_t t_first;   // Время первого отсчета
+    uint32_t t_last;    // Время последнего отсчета
+    uint64_t dt_sum;    // Сумма интервалов внутри блока
+    uint32_t dt_max;    // Наибольший интервал внутри блока
+};
+
+// Точка кривой
+struct AdevPoint {
+    double tau;
+    double adev[AXES];
+};
+
+// Шумовые параметры оси (в единицах оси: g или °/s)
+struct NoiseParams {
+    double white;       // Плотность белого шума, ед/√Гц (= случайное блуждание, ед·√с)
+    double bias;        // Нестабильность нуля, ед
+    double bias_tau;    // tau минимума, с
+    double rrw;         // Случайное блуждание скорости, ед/√с (0 — участок не найден)
+};
+
+/**
+ * @brief Оценивает шумовые параметры по кривой девиации Аллана
+ * 
+ * Участки с наклоном -1/2 и +1/2 ищутся по локальному наклону кривой
+ * в логарифмическом масштабе (IEEE Std 952).
+ */
+static NoiseParams fit_noise(const std::vector<AdevPoint>& curve, int axis) {
+    NoiseParams p = { 0, 0, 0, 0 };
+    size_t n = curve.size();
+    if (n < 3) {
+        return p;
+    }
+
+    double best_white = 1e9, best_rrw = 1e9;
+    p.bias = curve[0].adev[axis];
+    p.bias_tau = curve[0].tau;
+    for (size_t i = 0; i < n; i++) {
+        const AdevPoint& c = curve[i];
+        if (c.adev[axis] < p.bias) {
+            p.bias = c.adev[axis];
+            p.bias_tau = c.tau;
+        }
+        if (i == 0 || i + 1 >= n) {
+            continue;
+        }
+        double slope = log(curve[i + 1].adev[axis] / curve[i - 1].adev[axis]) /
+                       log(curve[i + 1].tau / curve[i - 1].tau);
+        if (fabs(slope + 0.5) < best_white) {
+            best_white = fabs(slope + 0.5);
+            p.white = c.adev[axis] * sqrt(c.tau);
+        }
+        if (fabs(slope - 0.5) < best_rrw) {
+            best_rrw = fabs(slope - 0.5);
+            p.rrw = c.adev[axis] * sqrt(3.0 / c.tau);
+        }
+    }
+    // Нестабильность нуля: σ_min / sqrt(2·ln2/π)
+    p.bias /= 0.664;
+    // Участок +1/2 достоверен только если наклон действительно близок к +1/2
+    if (best_rrw > 0.15) {
+        p.rrw = 0;
+    }
+    return p;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s log.bin [--block 512] [--acc-g 4] [--gyr-dps 2000] [--threads N]\n", argv[0]);
+        return 2;
+    }
+    uint16_t block_size = 512;
+    double acc_g = 4, gyr_dps = 2000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--block") == 0) block_size = (uint16_t)atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--acc-g") == 0) acc_g = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--gyr-dps") == 0) gyr_dps = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = (unsigned)std::max(1, atoi(argv[i + 1]));
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    // Масштаб: полный диапазон соответствует 32768 LSB
+    const double scale[AXES] = {
+        acc_g / 32768.0, acc_g / 32768.0, acc_g / 32768.0,
+        gyr_dps / 32768.0, gyr_dps / 32768.0, gyr_dps / 32768.0,
+    };
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || block_size < IMU_LOG_HEADER_SIZE) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    size_t nblocks = (size_t)st.st_size / block_size;
+    if (nblocks == 0) {
+        fprintf(stderr, "%s: no complete blocks\n", argv[1]);
+        return 2;
+    }
+    const uint8_t* data = (const uint8_t*)mmap(nullptr, nblocks * block_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "mmap failed on %s\n", argv[1]);
+        return 2;
+    }
+    madvise((void*)data, nblocks * block_size, MADV_SEQUENTIAL);
+
+    double t_start = wall_seconds();
+
+    // Проход 1: количество отсчетов по заголовкам — только чтение заголовков
+    std::vector<BlockMeta> meta(nblocks);
+    parallel(threads, [&](unsigned w) {
+        for (size_t b = w; b < nblocks; b += threads) {
+            IMU_LogBlockInfo info;
+            meta[b].count = IMU_logBlockInfo(data + b * block_size, block_size, &info) ? info.count : 0;
+        }
+    });
+    size_t total = 0;
+    for (auto& m : meta) {
+        m.first = total;
+        total += m.count;
+    }
+    if (total < 16) {
+        fprintf(stderr, "%s: too few samples (%lu)\n", argv[1], (unsigned long)total);
+        return 2;
+    }
+
+    // Проход 2: параллельное декодирование в столбцы; каждый поток пишет
+    // непрерывный диапазон блоков, без разделения строк кэша с соседями
+    std::vector<std::vector<int16_t>> col(AXES, std::vector<int16_t>(total));
+    std::atomic<unsigned long> corrupt(0);
+    parallel(threads, [&](unsigned w) {
+        size_t b0 = nblocks * w / threads, b1 = nblocks * (w + 1) / threads;
+        IMU_Sample s[IMU_LOG_MAX_SAMPLES];
+        for (size_t b = b0; b < b1; b++) {
+            BlockMeta& m = meta[b];
+            if (m.count == 0) {
+                corrupt++;
+                continue;
+            }
+            int n = IMU_logDecodeBlock(data + b * block_size, block_size, s, IMU_LOG_MAX_SAMPLES);
+            if (n != (int)m.count) {
+                // Заголовок цел, но данные повреждены: отсчеты повторяют последний
+                // корректный, чтобы не сдвигать индексы соседних блоков
+                corrupt++;
+                n = n < 0 ? 0 : n;
+                for (int i = n; i < (int)m.count; i++) {
+                    s[i] = n ? s[n - 1] : IMU_Sample();
+                }
+            }
+            m.t_first = s[0].t_us;
+            m.t_last = s[m.count - 1].t_us;
+            m.dt_sum = 0;
+            m.dt_max = 0;
+            for (uint32_t i = 0; i < m.count; i++) {
+                size_t k = m.first + i;
+                col[0][k] = s[i].acc[0]; col[1][k] = s[i].acc[1]; col[2][k] = s[i].acc[2];
+                col[3][k] = s[i].gyr[0]; col[4][k] = s[i].gyr[1]; col[5][k] = s[i].gyr[2];
+                if (i) {
+                    uint32_t dt = s[i].t_us - s[i - 1].t_us;
+                    m.dt_sum += dt;
+                    m.dt_max = std::max(m.dt_max, dt);
+                }
+            }
+        }
+    });
+    munmap((void*)data, nblocks * block_size);
+    close(fd);
+
+    // Длительность записи: интервалы с учетом переполнения micros() (каждые ~71 мин)
+    uint64_t span_us = 0;
+    uint32_t dt_max = 0;
+    const BlockMeta* prev = nullptr;
+    for (const auto& m : meta) {
+        if (m.count == 0) {
+            continue;
+        }
+        span_us += m.dt_sum;
+        dt_max = std::max(dt_max, m.dt_max);
+        if (prev) {
+            uint32_t dt = m.t_first - prev->t_last;
+            span_us += dt;
+            dt_max = std::max(dt_max, dt);
+        }
+        prev = &m;
+    }
+    double tau0 = span_us * 1e-6 / (double)(total - 1);
+    double t_decode = wall_seconds();
+
+    // Множители m: логарифмическая сетка, m ≤ (N - 1) / 2
+    std::vector<size_t> ms;
+    size_t m_max = (total - 1) / 2;
+    for (int i = 0;; i++) {
+        size_t m = (size_t)floor(pow(10.0, (double)i / POINTS_PER_DECADE));
+        if (m > m_max) break;
+        if (ms.empty() || m != ms.back()) ms.push_back(m);
+    }
+
+    std::vector<AdevPoint> curve(ms.size());
+    for (size_t j = 0; j < ms.size(); j++) {
+        curve[j].tau = ms[j] * tau0;
+    }
+
+    // θ[k] = Σ_{i<k} x[i] — точная целочисленная накопленная сумма
+    std::vector<int64_t> theta(total + 1);
+    for (int a = 0; a < AXES; a++) {
+        const int16_t* x = col[a].data();
+
+        // Параллельная префиксная сумма: суммы частей, затем смещения
+        std::vector<int64_t> part(threads + 1, 0);
+        parallel(threads, [&](unsigned w) {
+            size_t i0 = total * w / threads, i1 = total * (w + 1) / threads;
+            int64_t acc = 0;
+            for (size_t i = i0; i < i1; i++) acc += x[i];
+            part[w + 1] = acc;
+        });
+        for (unsigned w = 0; w < threads; w++) part[w + 1] += part[w];
+        theta[0] = 0;
+        parallel(threads, [&](unsigned w) {
+            size_t i0 = total * w / threads, i1 = total * (w + 1) / threads;
+            int64_t acc = part[w];
+            for (size_t i = i0; i < i1; i++) {
+                acc += x[i];
+                theta[i + 1] = acc;
+            }
+        });
+        std::vector<int16_t>().swap(col[a]);
+
+        // Задания (m, часть диапазона k), раздаются потокам через атомарный счетчик
+        struct Task { size_t mi, k0, k1; };
+        std::vector<Task> tasks;
+        for (size_t j = 0; j < ms.size(); j++) {
+            size_t kn = total + 1 - 2 * ms[j];
+            for (size_t k0 = 0; k0 < kn; k0 += CHUNK) {
+                tasks.push_back({ j, k0, std::min(kn, k0 + CHUNK) });
+            }
+        }
+        std::vector<double> partial(tasks.size());
+        std::atomic<size_t> next(0);
+        parallel(threads, [&](unsigned) {
+            for (size_t t; (t = next.fetch_add(1)) < tasks.size();) {
+                const Task& task = tasks[t];
+                size_t m = ms[task.mi];
+                const int64_t* p0 = theta.data();
+                const int64_t* p1 = p0 + m;
+                const int64_t* p2 = p0 + 2 * m;
+                double acc = 0;
+                for (size_t k = task.k0; k < task.k1; k++) {
+                    double d = (double)(p2[k] - 2 * p1[k] + p0[k]);
+                    acc += d * d;
+                }
+                partial[t] = acc;
+            }
+        });
+
+        std::vector<double> sum(ms.size(), 0.0);
+        for (size_t t = 0; t < tasks.size(); t++) sum[tasks[t].mi] += partial[t];
+        for (size_t j = 0; j < ms.size(); j++) {
+            // σ²(τ) = Σ(θ[k+2m] - 2θ[k+m] + θ[k])² / (2 m² (N - 2m)) в единицах LSB²
+            double m = (double)ms[j];
+            double kn = (double)(total + 1 - 2 * ms[j]);
+            curve[j].adev[a] = sqrt(sum[j] / (2.0 * m * m * kn)) * scale[a];
+        }
+    }
+    double t_end = wall_seconds();
+
+    printf("tau_s");
+    for (int a = 0; a < AXES; a++) printf("\t%s", axis_names[a]);
+    printf("\n");
+    for (const auto& c : curve) {
+        printf("%.6g", c.tau);
+        for (int a = 0; a < AXES; a++) printf("\t%.6g", c.adev[a]);
+        printf("\n");
+    }
+
+    fprintf(stderr, "samples: %lu, blocks: %lu (corrupt: %lu), duration %.1f s, tau0 %.6g s\n",
+            (unsigned long)total, (unsigned long)nblocks, corrupt.load(), span_us * 1e-6, tau0);
+    if (dt_max > 1.5 * tau0 * 1e6) {
+        fprintf(stderr, "warning: max sample interval %lu us (gaps bias the result)\n", (unsigned long)dt_max);
+    }
+    fprintf(stderr, "%-6s %14s %14s %14s %10s %14s\n", "axis", "noise density", "random walk", "bias instab.", "at tau,s", "rate rw");
+    for (int a = 0; a < AXES; a++) {
+        NoiseParams p = fit_noise(curve, a);
+        if (a < 3) {
+            // Акселерометр: мкg/√Гц, м/с/√ч, мкg, мкg/√с
+            fprintf(stderr, "%-6s %9.2f ug/rtHz %8.4f m/s/rth %10.2f ug %10.1f ",
+                    axis_names[a], p.white * 1e6, p.white * 9.80665 * 60, p.bias * 1e6, p.bias_tau);
+            if (p.rrw > 0) fprintf(stderr, "%9.3f ug/rts\n", p.rrw * 1e6);
+            else fprintf(stderr, "%14s\n", "n/a");
+        } else {
+            // Гироскоп: °/с/√Гц, °/√ч, °/ч, °/ч/√ч
+            fprintf(stderr, "%-6s %8.5f dps/rtHz %9.4f deg/rth %8.3f deg/h %10.1f ",
+                    axis_names[a], p.white, p.white * 60, p.bias * 3600, p.bias_tau);
+            if (p.rrw > 0) fprintf(stderr, "%9.3f deg/h/rth\n", p.rrw * 3600 * 60);
+            else fprintf(stderr, "%14s\n", "n/a");
+        }
+    }
+    fprintf(stderr, "time: decode %.2f s, allan %.2f s, %u threads\n",
+            t_decode - t_start, t_end - t_decode, threads);
+    return corrupt ? 1 : 0;
+}
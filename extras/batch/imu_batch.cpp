@@ -0,0 +1,636 @@
+/**
+ * @file imu_batch.cpp
+ * @brief Параллельная пакетная обработка записей трафика IMU на Linux-хосте
+ *
+ * Прогоняет множество записей IMU_captureBegin() через код драйвера и этапы
+ * обработки библиотеки и сохраняет результат в столбцовом формате. Для каждой
+ * записи:
+ * 1. Декодирование: IMU_begin() и IMU_readData() на шине воспроизведения
+ *    (IMU_replayBus) до конца записи, отсчеты раскладываются по столбцам
+ *    блока (BLOCK_ROWS строк)
+ * 2. Калибровка: перевод в g, °/s и мкТл с масштабом по метке диапазона
+ *    каждого отсчета (IMU_getSampleRanges)
+ * 3. Ориентация: курс, тангаж и крен (IMU_computeHeading)
+ * 4. Статистика: оконные сводки IMU_Stats
+ * Все этапы проходят по одному блоку, пока он в кэше, затем блок записывается
+ * группой строк и буфер используется снова — память не зависит от длины записи.
+ *
+ * Параллельность:
+ * - Файлы распределяются по N рабочим процессам (по умолчанию — число ядер):
+ *   отсортированы по размеру и розданы по кругу, у каждого рабочего своя очередь
+ * - Рабочий берет файлы из начала своей очереди; опустевший рабочий забирает
+ *   половину оставшихся файлов с конца очереди самого загруженного (work stealing)
+ * - Состояние драйвера глобальное, поэтому каждый файл обрабатывается
+ *   в отдельном дочернем процессе; файл отображается в память (mmap)
+ *
+ * Столбцовый формат (.imut, little-endian):
+ * - Заголовок: 'I' 'M' 'U' 'T', версия (uint16, 1), число столбцов (uint16),
+ *   затем для каждого столбца: тип (uint8: 1 — uint8, 2 — int16, 3 — uint16,
+ *   4 — uint32, 5 — float), длина имени (uint8), имя
+ * - Группы строк до конца файла: число строк (uint32), затем значения
+ *   каждого столбца подряд (rows * размер типа)
+ *
+ * Для записи capture.bin создаются <out>/capture.imut (отсчеты) и
+ * <out>/capture.stats.imut (сводки по окнам). Без -o результаты не
+ * сохраняются (измерение пропускной способности).
+ *
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_BMI160_BMM150.cpp IMU_Sched.cpp \
+ *       IMU_Capture.cpp IMU_Heading.cpp IMU_Stats.cpp extras/host/host_arduino.cpp \
+ *       extras/batch/imu_batch.cpp -o imu_batch
+ *
+ * Использование:
+ *   ./imu_batch -o results field/c001.bin field/c002.bin ...
+ *   ./imu_batch -j 8 --window 200 --list files.txt -o results
+ *
+ * Сводка в stderr: отсчеты и файлы каждого рабочего, число краж очереди,
+ * отсчеты в секунду на ядро и суммарно. Код возврата 1, если какой-либо
+ * файл не прочитан или драйвер разошелся с записью (IMU_replayMismatches).
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+#include "IMU_Capture.h"
+#include "IMU_Heading.h"
+#include "IMU_Stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+// Строк в блоке: все столбцы блока (~70 КБ) помещаются в L2
+#define BLOCK_ROWS 1024
+
+// === СТОЛБЦОВЫЙ ФАЙЛ ===
+
+enum ColType : uint8_t { COL_U8 = 1, COL_I16 = 2, COL_U16 = 3, COL_U32 = 4, COL_F32 = 5 };
+
+static const uint8_t col_size[6] = { 0, 1, 2, 2, 4, 4 };
+
+struct Column {
+    const char* name;
+    uint8_t type;
+    const void* data;   // Значения текущей группы строк
+};
+
+static FILE* table_create(const std::string& path, const Column* cols, uint16_t count) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        return nullptr;
+    }
+    setvbuf(f, nullptr, _IOFBF, 1 << 20);
+    const uint8_t head[8] = { 'I', 'M', 'U', 'T', 1, 0, (uint8_t)count, (uint8_t)(count >> 8) };
+    fwrite(head, 1, sizeof(head), f);
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t desc[2] = { cols[i].type, (uint8_t)strlen(cols[i].name) };
+        fwrite(desc, 1, 2, f);
+        fwrite(cols[i].name, 1, desc[1], f);
+    }
+    return f;
+}
+
+static bool table_write_group(FILE* f, const Column* cols, uint16_t count, uint32_t rows) {
+    const uint8_t n[4] = { (uint8_t)rows, (uint8_t)(rows >> 8), (uint8_t)(rows >> 16), (uint8_t)(rows >> 24) };
+    fwrite(n, 1, 4, f);
+    for (uint16_t i = 0; i < count; i++) {
+        fwrite(cols[i].data, col_size[cols[i].type], rows, f);
+    }
+    return !ferror(f);
+}
+
+// === ЭТАПЫ ОБРАБОТКИ ===
+
+// Блок отсчетов по столбцам
+struct Block {
+    uint32_t rows;
+    uint32_t t_us[BLOCK_ROWS];
+    int16_t raw[10][BLOCK_ROWS];        // ax ay az gx gy gz mx my mz rhall
+    uint8_t acc_range[BLOCK_ROWS];
+    uint8_t gyr_range[BLOCK_ROWS];
+    float phys[9][BLOCK_ROWS];          // g, °/s, мкТл
+    uint16_t heading[BLOCK_ROWS];       // Сотые доли градуса
+    int16_t pitch[BLOCK_ROWS];
+    int16_t roll[BLOCK_ROWS];
+};
+
+static const char* const raw_names[10] = { "ax", "ay", "az", "gx", "gy", "gz", "mx", "my", "mz", "rhall" };
+static const char* const phys_names[9] = { "ax_g", "ay_g", "az_g", "gx_dps", "gy_dps", "gz_dps", "mx_ut", "my_ut", "mz_ut" };
+
+/**
+ * @brief Декодирование: читает до BLOCK_ROWS отсчетов записи в столбцы блока
+ */
+static void stage_decode(Block* b) {
+    b->rows = 0;
+    while (b->rows < BLOCK_ROWS && !IMU_replayDone()) {
+        IMU_Sample s;
+        IMU_readData(s.acc, s.gyr, s.mag, &s.rhall);
+        if (IMU_replayUnderrun()) {
+            break; // Запись закончилась посреди последнего чтения
+        }
+        uint32_t k = b->rows++;
+        uint32_t accgyr_us, mag_us;
+        IMU_getSampleTimes(&accgyr_us, &mag_us);
+        b->t_us[k] = accgyr_us;
+        for (uint8_t i = 0; i < 3; i++) {
+            b->raw[i][k] = s.acc[i];
+            b->raw[3 + i][k] = s.gyr[i];
+            b->raw[6 + i][k] = s.mag[i];
+        }
+        b->raw[9][k] = s.rhall;
+        IMU_getSampleRanges(&b->acc_range[k], &b->gyr_range[k]);
+    }
+}
+
+static float acc_lsb(uint8_t range) {
+    switch (range) {
+        case 0x05: return 8192.0f;
+        case 0x08: return 4096.0f;
+        case 0x0C: return 2048.0f;
+        default: return 16384.0f;
+    }
+}
+
+static float gyr_lsb(uint8_t range) {
+    switch (range) {
+        case 0x00: return 16.384f;
+        case 0x01: return 32.768f;
+        case 0x02: return 65.536f;
+        case 0x04: return 262.144f;
+        default: return 131.072f;
+    }
+}
+
+/**
+ * @brief Калибровка: физические единицы по метке диапазона каждого отсчета
+ *
+ * Масштаб отсчетов считается один раз, затем каждая ось проходится
+ * отдельным циклом по столбцу (векторизуется компилятором).
+ */
+static void stage_calibrate(Block* b) {
+    float acc_scale[BLOCK_ROWS], gyr_scale[BLOCK_ROWS];
+    for (uint32_t k = 0; k < b->rows; k++) {
+        acc_scale[k] = 1.0f / acc_lsb(b->acc_range[k]);
+        gyr_scale[k] = 1.0f / gyr_lsb(b->gyr_range[k]);
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        const int16_t* a = b->raw[i];
+        const int16_t* g = b->raw[3 + i];
+        const int16_t* m = b->raw[6 + i];
+        float* pa = b->phys[i];
+        float* pg = b->phys[3 + i];
+        float* pm = b->phys[6 + i];
+        for (uint32_t k = 0; k < b->rows; k++) {
+            pa[k] = a[k] * acc_scale[k];
+            pg[k] = g[k] * gyr_scale[k];
+            pm[k] = m[k] * MAG_LSB_UT;
+        }
+    }
+}
+
+/**
+ * @brief Ориентация: курс, тангаж и крен по сырым acc и mag
+ */
+static void stage_heading(Block* b) {
+    for (uint32_t k = 0; k < b->rows; k++) {
+        const int16_t acc[3] = { b->raw[0][k], b->raw[1][k], b->raw[2][k] };
+        const int16_t mag[3] = { b->raw[6][k], b->raw[7][k], b->raw[8][k] };
+        IMU_Heading h = { 0, 0, 0 };
+        IMU_computeHeading(acc, mag, &h);
+        b->heading[k] = h.heading_cdeg;
+        b->pitch[k] = h.pitch_cdeg;
+        b->roll[k] = h.roll_cdeg;
+    }
+}
+
+// Сводки окон: столбцы t_start_us, t_end_us, n, затем mean и std каждой оси
+struct StatsTable {
+    std::vector<uint32_t> t_start, t_end, n;
+    std::vector<float> mean[IMU_STATS_CHANNELS];
+    std::vector<float> std_dev[IMU_STATS_CHANNELS];
+};
+
+/**
+ * @brief Статистика: отсчеты блока в IMU_Stats, готовые сводки — в таблицу
+ */
+static void stage_stats(const Block* b, IMU_Stats* st, StatsTable* out) {
+    for (uint32_t k = 0; k < b->rows; k++) {
+        IMU_Sample s;
+        s.t_us = b->t_us[k];
+        for (uint8_t i = 0; i < 3; i++) {
+            s.acc[i] = b->raw[i][k];
+            s.gyr[i] = b->raw[3 + i][k];
+            s.mag[i] = b->raw[6 + i][k];
+        }
+        s.rhall = b->raw[9][k];
+        if (!IMU_statsPush(st, &s)) {
+            continue;
+        }
+        const IMU_StatsWindow* w = IMU_statsResult(st);
+        out->t_start.push_back(w->t_start_us);
+        out->t_end.push_back(w->t_end_us);
+        out->n.push_back(w->n);
+        for (uint8_t i = 0; i < IMU_STATS_CHANNELS; i++) {
+            out->mean[i].push_back(w->mean[i]);
+            out->std_dev[i].push_back(w->std[i]);
+        }
+    }
+}
+
+// === ОБРАБОТКА ФАЙЛА ===
+
+struct Options {
+    const char* out_dir;
+    uint32_t window;
+};
+
+// Результат обработки файла (в общей памяти, заполняет дочерний процесс)
+struct FileResult {
+    uint64_t samples;
+    uint32_t mismatches;
+    bool ok;
+};
+
+static std::string output_base(const char* path, const char* out_dir) {
+    std::string name(path);
+    size_t slash = name.rfind('/');
+    if (slash != std::string::npos) {
+        name = name.substr(slash + 1);
+    }
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos && dot > 0) {
+        name = name.substr(0, dot);
+    }
+    return std::string(out_dir) + "/" + name;
+}
+
+static bool write_stats(const std::string& path, StatsTable* t) {
+    static char names[2 * IMU_STATS_CHANNELS][16];
+    Column cols[3 + 2 * IMU_STATS_CHANNELS] = {
+        { "t_start_us", COL_U32, t->t_start.data() },
+        { "t_end_us", COL_U32, t->t_end.data() },
+        { "n", COL_U32, t->n.data() },
+    };
+    for (uint8_t i = 0; i < IMU_STATS_CHANNELS; i++) {
+        snprintf(names[2 * i], sizeof(names[0]), "%s_mean", raw_names[i]);
+        snprintf(names[2 * i + 1], sizeof(names[0]), "%s_std", raw_names[i]);
+        cols[3 + 2 * i] = { names[2 * i], COL_F32, t->mean[i].data() };
+        cols[4 + 2 * i] = { names[2 * i + 1], COL_F32, t->std_dev[i].data() };
+    }
+    const uint16_t count = sizeof(cols) / sizeof(cols[0]);
+    FILE* f = table_create(path, cols, count);
+    if (!f) {
+        return false;
+    }
+    bool ok = table_write_group(f, cols, count, (uint32_t)t->t_start.size());
+    return fclose(f) == 0 && ok;
+}
+
+/**
+ * @brief Обрабатывает одну запись (вызывается в отдельном процессе)
+ */
+static void process_file(const char* path, const Options& opt, FileResult* res) {
+    res->samples = 0;
+    res->mismatches = 0;
+    res->ok = false;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size == 0) {
+        fprintf(stderr, "%s: empty or unreadable\n", path);
+        close(fd);
+        return;
+    }
+    size_t len = (size_t)sb.st_size;
+    void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "%s: mmap: %s\n", path, strerror(errno));
+        return;
+    }
+    madvise(map, len, MADV_SEQUENTIAL);
+
+    if (!IMU_replayBegin((const uint8_t*)map, len, host_setMicros)) {
+        fprintf(stderr, "%s: not an IMU capture (version %d expected)\n", path, IMU_CAPTURE_VERSION);
+        munmap(map, len);
+        return;
+    }
+    IMU_setBus(IMU_replayBus());
+    IMU_begin();
+
+    static Block b;
+    Column cols[25];
+    uint16_t count = 0;
+    cols[count++] = { "t_us", COL_U32, b.t_us };
+    for (uint8_t i = 0; i < 10; i++) cols[count++] = { raw_names[i], COL_I16, b.raw[i] };
+    cols[count++] = { "acc_range", COL_U8, b.acc_range };
+    cols[count++] = { "gyr_range", COL_U8, b.gyr_range };
+    for (uint8_t i = 0; i < 9; i++) cols[count++] = { phys_names[i], COL_F32, b.phys[i] };
+    cols[count++] = { "heading_cdeg", COL_U16, b.heading };
+    cols[count++] = { "pitch_cdeg", COL_I16, b.pitch };
+    cols[count++] = { "roll_cdeg", COL_I16, b.roll };
+
+    std::string base = opt.out_dir ? output_base(path, opt.out_dir) : std::string();
+    FILE* out = nullptr;
+    if (opt.out_dir && !(out = table_create(base + ".imut", cols, count))) {
+        fprintf(stderr, "%s: cannot create %s.imut\n", path, base.c_str());
+        munmap(map, len);
+        return;
+    }
+
+    IMU_Stats st;
+    IMU_statsInit(&st, opt.window, 1);
+    StatsTable stats;
+    bool ok = true;
+    for (;;) {
+        stage_decode(&b);
+        if (b.rows == 0) {
+            break;
+        }
+        stage_calibrate(&b);
+        stage_heading(&b);
+        stage_stats(&b, &st, &stats);
+        if (out) {
+            ok = table_write_group(out, cols, count, b.rows) && ok;
+        }
+        res->samples += b.rows;
+    }
+    if (out) {
+        ok = fclose(out) == 0 && ok;
+        ok = write_stats(base + ".stats.imut", &stats) && ok;
+        if (!ok) {
+            fprintf(stderr, "%s: write error in %s\n", path, opt.out_dir);
+        }
+    }
+
+    res->mismatches = IMU_replayMismatches();
+    if (res->mismatches) {
+        fprintf(stderr, "%s: %lu replay mismatches\n", path, (unsigned long)res->mismatches);
+    }
+    res->ok = ok;
+    munmap(map, len);
+}
+
+// === ОЧЕРЕДИ С КРАЖЕЙ РАБОТЫ ===
+
+// Очередь рабочего — диапазон [head, tail) общего массива индексов файлов
+struct WorkQueue {
+    std::atomic<uint32_t> lock;
+    uint32_t head;
+    uint32_t tail;
+};
+
+struct WorkerStats {
+    uint64_t samples;
+    uint32_t files;
+    uint32_t failed;
+    uint32_t steals;
+    double busy_s;
+};
+
+// Общая память рабочих процессов (MAP_SHARED)
+struct Shared {
+    uint32_t workers;
+    WorkQueue* queues;
+    WorkerStats* stats;
+    FileResult* results;  // По одному на рабочего
+};
+
+static void queue_lock(WorkQueue* q) {
+    while (q->lock.exchange(1, std::memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void queue_unlock(WorkQueue* q) {
+    q->lock.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Берет следующий файл из начала собственной очереди
+ */
+static bool queue_pop(WorkQueue* q, uint32_t* item, const uint32_t* order) {
+    queue_lock(q);
+    bool ok = q->head < q->tail;
+    if (ok) {
+        *item = order[q->head++];
+    }
+    queue_unlock(q);
+    return ok;
+}
+
+/**
+ * @brief Переносит половину оставшихся файлов самого загруженного рабочего к себе
+ *
+ * @return false если работы не осталось ни у кого
+ */
+static bool queue_steal(Shared* sh, uint32_t self) {
+    for (;;) {
+        uint32_t victim = self;
+        uint32_t most = 0;
+        for (uint32_t w = 0; w < sh->workers; w++) {
+            uint32_t left = sh->queues[w].tail - sh->queues[w].head; // Оценка без блокировки
+            if (w != self && left > most) {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim == self) {
+            return false;
+        }
+        WorkQueue* v = &sh->queues[victim];
+        WorkQueue* own = &sh->queues[self];
+        queue_lock(v);
+        uint32_t left = v->tail - v->head;
+        if (left == 0) {
+            queue_unlock(v);
+            continue; // Очередь опустела, пока выбирали
+        }
+        uint32_t take = (left + 1) / 2;
+        queue_lock(own);
+        own->head = v->tail - take;
+        own->tail = v->tail;
+        queue_unlock(own);
+        v->tail -= take;
+        queue_unlock(v);
+        sh->stats[self].steals++;
+        return true;
+    }
+}
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void worker_main(Shared* sh, uint32_t self, const std::vector<std::string>& files,
+                        const uint32_t* order, const Options& opt) {
+    WorkerStats* ws = &sh->stats[self];
+    FileResult* res = &sh->results[self];
+    for (;;) {
+        uint32_t item;
+        if (!queue_pop(&sh->queues[self], &item, order)) {
+            if (!queue_steal(sh, self)) {
+                break;
+            }
+            continue;
+        }
+        double t0 = wall_seconds();
+        res->ok = false;
+        res->samples = 0;
+        pid_t pid = fork();
+        if (pid == 0) {
+            process_file(files[item].c_str(), opt, res);
+            fflush(stderr);
+            _exit(0);
+        }
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status)) {
+            fprintf(stderr, "%s: worker process failed\n", files[item].c_str());
+            res->ok = false;
+        }
+        ws->busy_s += wall_seconds() - t0;
+        ws->files++;
+        ws->samples += res->samples;
+        if (!res->ok || res->mismatches) {
+            ws->failed++;
+        }
+    }
+}
+
+static void* shared_alloc(size_t size) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        exit(2);
+    }
+    return p;
+}
+
+static bool load_list(const char* path, std::vector<std::string>* files) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (line[0]) {
+            files->push_back(line);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options opt = { nullptr, 100 };
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            opt.out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            opt.window = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            if (!load_list(argv[++i], &files)) {
+                fprintf(stderr, "cannot read %s\n", argv[i]);
+                return 2;
+            }
+        } else if (argv[i][0] == '-') {
+            files.clear();
+            break;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    IMU_Stats probe;
+    if (files.empty() || jobs < 1 || !IMU_statsInit(&probe, opt.window, 1)) {
+        fprintf(stderr, "usage: %s [-j workers] [-o out_dir] [--window samples] [--list files.txt] capture.bin...\n", argv[0]);
+        return 2;
+    }
+    if (opt.out_dir && mkdir(opt.out_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(stderr, "cannot create %s: %s\n", opt.out_dir, strerror(errno));
+        return 2;
+    }
+    uint32_t workers = (uint32_t)std::min<long>(jobs, (long)files.size());
+
+    // Большие файлы первыми, по кругу: у каждого рабочего смесь размеров
+    std::vector<std::pair<off_t, uint32_t> > by_size(files.size());
+    for (uint32_t i = 0; i < files.size(); i++) {
+        struct stat sb;
+        by_size[i] = std::make_pair(stat(files[i].c_str(), &sb) == 0 ? sb.st_size : 0, i);
+    }
+    std::sort(by_size.begin(), by_size.end(), [](const std::pair<off_t, uint32_t>& a, const std::pair<off_t, uint32_t>& b) {
+        return a.first > b.first;
+    });
+    std::vector<uint32_t> order;
+    Shared sh;
+    sh.workers = workers;
+    sh.queues = (WorkQueue*)shared_alloc(workers * sizeof(WorkQueue));
+    sh.stats = (WorkerStats*)shared_alloc(workers * sizeof(WorkerStats));
+    sh.results = (FileResult*)shared_alloc(workers * sizeof(FileResult));
+    for (uint32_t w = 0; w < workers; w++) {
+        new (&sh.queues[w].lock) std::atomic<uint32_t>(0);
+        sh.queues[w].head = (uint32_t)order.size();
+        for (uint32_t i = w; i < by_size.size(); i += workers) {
+            order.push_back(by_size[i].second);
+        }
+        sh.queues[w].tail = (uint32_t)order.size();
+    }
+
+    fflush(stdout);
+    double t0 = wall_seconds();
+    std::vector<pid_t> pids;
+    for (uint32_t w = 0; w < workers; w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            worker_main(&sh, w, files, order.data(), opt);
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+    for (size_t i = 0; i < pids.size(); i++) {
+        waitpid(pids[i], nullptr, 0);
+    }
+    double elapsed = wall_seconds() - t0;
+
+    uint64_t samples = 0;
+    uint32_t done = 0, failed = 0;
+    for (uint32_t w = 0; w < workers; w++) {
+        const WorkerStats& ws = sh.stats[w];
+        fprintf(stderr, "worker %u: %u files, %llu samples, %u steals, %.0f samples/s\n", w, ws.files,
+                (unsigned long long)ws.samples, ws.steals, ws.busy_s > 0 ? ws.samples / ws.busy_s : 0.0);
+        samples += ws.samples;
+        done += ws.files;
+        failed += ws.failed;
+    }
+    fprintf(stderr, "files: %u (%u failed)\n", done, failed);
+    fprintf(stderr, "samples: %llu\n", (unsigned long long)samples);
+    fprintf(stderr, "time: %.3f s, %u workers\n", elapsed, workers);
+    fprintf(stderr, "throughput: %.0f samples/s, %.0f samples/s per core\n",
+            elapsed > 0 ? samples / elapsed : 0.0, elapsed > 0 ? samples / elapsed / workers : 0.0);
+    return failed == 0 && done == files.size() ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file driver_bench.cpp
+ * @brief Бенчмарк драйвера с порогами регрессии на Linux-хосте
+ * 
+ * Прогоняет драйвер на модели регистров (extras/host/imu_model.h) в двух
+ * сценариях подключения магнитометра (primary — BMM150 на основной шине,
+ * secondary — за BMI160) и измеряет:
+ * - IMU_begin(): транзакции, байты на линии, виртуальное время (паузы + обмен)
+ * - IMU_readData(): то же на один вызов (среднее по 100 вызовам)
+ * - IMU_readChannels(IMU_CHANNEL_GYR): то же для чтения только гироскопа
+ * - IMU_readDataWithFrequency(): то же за 1 с опроса с шагом 1 мс при 50 Гц
+ * - повторный IMU_begin() после пропадания питания BMM150: магнитометр
+ *   снова включен и измеряет (restart_begin_ok)
+ * - время CPU на IMU_readData() при мгновенной шине (разбор пакета и логика драйвера)
+ * - время CPU на перевод 9 осей в физические единицы
+ * 
+ * Счетчики детерминированы и сравниваются с эталоном точно: превышение
+ * любой величины — ошибка (код возврата 1). Время CPU зависит от машины
+ * и сравнивается с допуском (по умолчанию ×3, --no-timing отключает).
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_BMI160_BMM150.cpp IMU_Sched.cpp \
+ *       extras/host/host_arduino.cpp extras/bench/driver_bench.cpp -o driver_bench
+ * 
+ * Использование:
+ *   ./driver_bench                                    # сравнить с extras/bench/driver_bench.baseline
+ *   ./driver_bench --baseline file [--no-timing]
+ *   ./driver_bench --write-baseline extras/bench/driver_bench.baseline
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+#include "imu_model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <vector>
+
+// Время передачи байта на 400 кГц (9 бит)
+static const uint32_t BYTE_US_400K = 23;
+
+static const int READ_CALLS = 100;
+static const int CPU_CALLS = 200000;
+
+struct Metric {
+    std::string name;
+    double value;
+};
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool is_timing(const std::string& name) {
+    return name.size() > 3 && name.compare(name.size() - 3, 3, "_ns") == 0;
+}
+
+/**
+ * @brief Выполняет сценарий и печатает метрики в fd (в отдельном процессе:
+ *        состояние драйвера статическое и не сбрасывается между IMU_begin())
+ */
+static void run_scenario(const char* name, bool primary, int fd) {
+    FILE* out = fdopen(fd, "w");
+    IMU_BusStats st;
+
+    imu_model_init(true, primary, !primary, BYTE_US_400K);
+    IMU_setBus(&imu_model_bus);
+    host_setMicros(1000);
+
+    IMU_resetBusStats();
+    uint32_t t0 = micros();
+    bool ok = IMU_begin();
+    uint32_t t1 = micros();
+    IMU_getBusStats(&st);
+    MagMode expected = primary ? PRIMARY : SECONDARY;
+    fprintf(out, "%s.begin_ok %d\n", name, ok && IMU_getMagMode() == expected ? 1 : 0);
+    fprintf(out, "%s.begin_transactions %lu\n", name, (unsigned long)st.transactions);
+    fprintf(out, "%s.begin_bytes %lu\n", name, (unsigned long)st.bytes);
+    fprintf(out, "%s.begin_us %lu\n", name, (unsigned long)(t1 - t0));
+
+    int16_t acc[3], gyr[3], mag[3], rhall;
+    IMU_resetBusStats();
+    t0 = micros();
+    for (int i = 0; i < READ_CALLS; i++) {
+        IMU_readData(acc, gyr, mag, &rhall);
+    }
+    t1 = micros();
+    IMU_getBusStats(&st);
+    fprintf(out, "%s.read_transactions %.2f\n", name, st.transactions / (double)READ_CALLS);
+    fprintf(out, "%s.read_bytes %.2f\n", name, st.bytes / (double)READ_CALLS);
+    fprintf(out, "%s.read_us %.2f\n", name, (t1 - t0) / (double)READ_CALLS);
+
+    IMU_resetBusStats();
+    t0 = micros();
+    for (int i = 0; i < READ_CALLS; i++) {
+        IMU_readChannels(IMU_CHANNEL_GYR, nullptr, gyr, nullptr, nullptr);
+    }
+    t1 = micros();
+    IMU_getBusStats(&st);
+    fprintf(out, "%s.gyro_transactions %.2f\n", name, st.transactions / (double)READ_CALLS);
+    fprintf(out, "%s.gyro_bytes %.2f\n", name, st.bytes / (double)READ_CALLS);
+    fprintf(out, "%s.gyro_us %.2f\n", name, (t1 - t0) / (double)READ_CALLS);
+
+    // Цикл приложения: вызов каждую 1 мс в течение 1 с, запрошено 50 Гц
+    IMU_resetBusStats();
+    uint32_t busy = 0;
+    uint32_t end = micros() + 1000000UL;
+    while ((int32_t)(micros() - end) < 0) {
+        uint32_t c0 = micros();
+        IMU_readDataWithFrequency(acc, gyr, mag, &rhall, 50.0f);
+        busy += micros() - c0;
+        host_advanceMicros(1000);
+    }
+    IMU_getBusStats(&st);
+    fprintf(out, "%s.freq50_transactions %lu\n", name, (unsigned long)st.transactions);
+    fprintf(out, "%s.freq50_bytes %lu\n", name, (unsigned long)st.bytes);
+    fprintf(out, "%s.freq50_busy_us %lu\n", name, (unsigned long)busy);
+
+    // Перезапуск после пропадания питания BMM150 (BMI160 питание сохранил):
+    // магнитометр в suspend, а теневая копия драйвера помнит POWER = 1
+    imu_model_bmm_reset();
+    host_advanceMicros(100000);
+    ok = IMU_begin() && IMU_getMagMode() == expected && imu_model_bmm_powered();
+    if (!primary) {
+        ok = ok && imu_model_mag_running();
+    }
+    fprintf(out, "%s.restart_begin_ok %d\n", name, ok ? 1 : 0);
+
+    // Время CPU: мгновенная шина, паузы драйвера не стоят реального времени
+    imu_model.byte_us = 0;
+    double w0 = wall_seconds();
+    for (int i = 0; i < CPU_CALLS; i++) {
+        IMU_readData(acc, gyr, mag, &rhall);
+    }
+    fprintf(out, "%s.read_cpu_ns %.1f\n", name, (wall_seconds() - w0) / CPU_CALLS * 1e9);
+    fclose(out);
+}
+
+/**
+ * @brief Время перевода сырых значений в g, °/s и мкТл (на отсчет)
+ */
+static double conversion_ns() {
+    static int16_t raw[1024][9];
+    for (int i = 0; i < 1024; i++) {
+        for (int k = 0; k < 9; k++) {
+            raw[i][k] = (int16_t)(i * 37 + k * 1009);
+        }
+    }
+    volatile float sink = 0;
+    const int rounds = 2000;
+    double w0 = wall_seconds();
+    for (int r = 0; r < rounds; r++) {
+        float sum = 0;
+        for (int i = 0; i < 1024; i++) {
+            const int16_t* v = raw[i];
+            float ax = v[0] / ACC_LSB, ay = v[1] / ACC_LSB, az = v[2] / ACC_LSB;
+            float gx = v[3] / GYR_LSB, gy = v[4] / GYR_LSB, gz = v[5] / GYR_LSB;
+            float mx = v[6] * MAG_LSB_UT, my = v[7] * MAG_LSB_UT, mz = v[8] * MAG_LSB_UT;
+            sum += ax + ay + az + gx + gy + gz + mx + my + mz;
+        }
+        sink = sink + sum;
+    }
+    return (wall_seconds() - w0) / (rounds * 1024.0) * 1e9;
+}
+
+static bool collect(const char* name, bool primary, std::vector<Metric>* metrics) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        run_scenario(name, primary, fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    FILE* in = fdopen(fds[0], "r");
+    char key[128];
+    double value;
+    while (fscanf(in, "%127s %lf", key, &value) == 2) {
+        metrics->push_back({ key, value });
+    }
+    fclose(in);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool load_baseline(const char* path, std::vector<Metric>* base) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char key[128];
+        double value;
+        if (line[0] != '#' && sscanf(line, "%127s %lf", key, &value) == 2) {
+            base->push_back({ key, value });
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* baseline = "extras/bench/driver_bench.baseline";
+    const char* write_path = nullptr;
+    bool timing = true;
+    double tolerance = 3.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline = argv[++i];
+        else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) write_path = argv[++i];
+        else if (strcmp(argv[i], "--no-timing") == 0) timing = false;
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--baseline file] [--write-baseline file] [--no-timing] [--tolerance x]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Metric> metrics;
+    if (!collect("primary", true, &metrics) || !collect("secondary", false, &metrics)) {
+        fprintf(stderr, "scenario process failed\n");
+        return 2;
+    }
+    metrics.push_back({ "convert_cpu_ns", conversion_ns() });
+
+    if (write_path) {
+        FILE* f = fopen(write_path, "w");
+        if (!f) {
+            fprintf(stderr, "cannot write %s\n", write_path);
+            return 2;
+        }
+        fprintf(f, "# driver_bench baseline: counts must not grow; *_ns allow a tolerance factor\n");
+        for (const auto& m : metrics) {
+            fprintf(f, "%s %.2f\n", m.name.c_str(), m.value);
+        }
+        fclose(f);
+        printf("baseline written to %s\n", write_path);
+        return 0;
+    }
+
+    std::vector<Metric> base;
+    bool have_base = load_baseline(baseline, &base);
+    if (!have_base) {
+        fprintf(stderr, "no baseline at %s (create with --write-baseline)\n", baseline);
+    }
+
+    int failures = 0;
+    printf("%-34s %12s %12s\n", "metric", "value", "baseline");
+    for (const auto& m : metrics) {
+        const Metric* b = nullptr;
+        for (const auto& x : base) {
+            if (x.name == m.name) b = &x;
+        }
+        const char* verdict = "";
+        if (b) {
+            bool timed = is_timing(m.name);
+            // begin_ok — признак успеха: меньше эталона означает регрессию
+            bool regressed = m.name.find("begin_ok") != std::string::npos ? m.value < b->value :
+                             timed ? timing && m.value > b->value * tolerance :
+                             m.value > b->value + 0.005;
+            if (regressed) {
+                verdict = "  REGRESSION";
+                failures++;
+            } else if (!timed && m.value < b->value - 0.005) {
+                verdict = "  improved";
+            }
+        }
+        if (b) {
+            printf("%-34s %12.2f %12.2f%s\n", m.name.c_str(), m.value, b->value, verdict);
+        } else {
+            printf("%-34s %12.2f %12s\n", m.name.c_str(), m.value, "-");
+        }
+    }
+    if (failures) {
+        printf("FAIL: %d metric(s) exceed the baseline\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
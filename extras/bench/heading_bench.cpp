@@ -0,0 +1,192 @@
+/**
+ * @file heading_bench.cpp
+ * @brief Точность и скорость курса в фиксированной точке (IMU_Heading) против float на Linux-хосте
+ * 
+ * Генерирует случайные ориентации (|тангаж| < 85°) и вектор магнитного поля
+ * с наклонением, квантует acc/mag в int16 как датчик и сравнивает:
+ * - IMU_computeHeading (CORDIC, целые)
+ * - ту же формулу в float (atan2f/sinf/cosf — как на контроллере с FPU)
+ * с эталоном в double на тех же целочисленных входах. Выводит наибольшую
+ * погрешность по каждому углу и время одного вычисления.
+ * 
+ * Перед этим IMU_atan2Fixed() проверяется на входах во всем диапазоне int32
+ * (до INT32_MIN и ±2^31-1): погрешность больше допуска — код возврата 1.
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_Heading.cpp \
+ *       extras/host/host_arduino.cpp extras/bench/heading_bench.cpp -o heading_bench
+ * 
+ * Для другой точности добавьте -DIMU_HEADING_ITERATIONS=12 и т.п.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_Heading.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const int CASES = 200000;
+
+static int16_t acc_in[CASES][3];
+static int16_t mag_in[CASES][3];
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+// Разность углов с учетом перехода через 360°
+static double angle_error(double a, double b) {
+    double e = fabs(a - b);
+    return e > 180 ? 360 - e : e;
+}
+
+/**
+ * @brief Погрешность IMU_atan2Fixed(y, x) в двоичных единицах (65536 = оборот)
+ */
+static double atan2_error(int32_t y, int32_t x) {
+    double ref = atan2((double)y, (double)x) / (2 * M_PI) * 65536.0;
+    double e = fabs(IMU_atan2Fixed(y, x) - ref);
+    return e > 32768 ? 65536 - e : e;
+}
+
+/**
+ * @brief IMU_atan2Fixed() на больших и предельных входах
+ * 
+ * @return Наибольшая погрешность (двоичные единицы)
+ */
+static double check_atan2_range() {
+    static const int32_t edge[][2] = {
+        { 1000000000, 1000000000 }, { -2000000000, 1000 }, { 0, -2147483647 },
+        { INT32_MIN, 0 }, { 0, INT32_MIN }, { INT32_MIN, INT32_MIN }, { INT32_MAX, INT32_MIN },
+        { INT32_MAX, INT32_MAX }, { 1, INT32_MAX }, { -1, INT32_MIN }, { 67108864, -67108863 },
+    };
+    double worst = 0;
+    for (const auto& c : edge) {
+        worst = fmax(worst, atan2_error(c[0], c[1]));
+    }
+    // Случайные углы на всех масштабах от 2^4 до 2^31
+    for (int n = 0; n < 100000; n++) {
+        double a = uniform(-M_PI, M_PI);
+        double len = ldexp(1.0, 4 + n % 28) * uniform(1.0, 1.999);
+        int32_t y = (int32_t)fmax(fmin(len * sin(a), INT32_MAX), INT32_MIN);
+        int32_t x = (int32_t)fmax(fmin(len * cos(a), INT32_MAX), INT32_MIN);
+        worst = fmax(worst, atan2_error(y, x));
+    }
+    return worst;
+}
+
+/**
+ * @brief Эталон в double на целочисленных входах
+ */
+static void reference(const int16_t* a, const int16_t* m, double* h, double* p, double* r) {
+    double roll = atan2((double)a[1], (double)a[2]);
+    double pitch = atan2(-(double)a[0], a[1] * sin(roll) + a[2] * cos(roll));
+    double by = m[1] * cos(roll) - m[2] * sin(roll);
+    double bx = m[0] * cos(pitch) + (m[1] * sin(roll) + m[2] * cos(roll)) * sin(pitch);
+    double hd = atan2(-by, bx) * 180 / M_PI;
+    *h = hd < 0 ? hd + 360 : hd;
+    *p = pitch * 180 / M_PI;
+    *r = roll * 180 / M_PI;
+}
+
+/**
+ * @brief Та же формула в float
+ */
+static void float_heading(const int16_t* a, const int16_t* m, float* h, float* p, float* r) {
+    float roll = atan2f(a[1], a[2]);
+    float sr = sinf(roll), cr = cosf(roll);
+    float pitch = atan2f(-(float)a[0], a[1] * sr + a[2] * cr);
+    float by = m[1] * cr - m[2] * sr;
+    float bx = m[0] * cosf(pitch) + (m[1] * sr + m[2] * cr) * sinf(pitch);
+    float hd = atan2f(-by, bx) * 57.29578f;
+    *h = hd < 0 ? hd + 360 : hd;
+    *p = pitch * 57.29578f;
+    *r = roll * 57.29578f;
+}
+
+int main() {
+    srand(3);
+    // Допуск: разрешение CORDIC atan(2^-(N-1)) плюс округление
+    double atan2_tol = 2.0 + atan(ldexp(1.0, 1 - IMU_HEADING_ITERATIONS)) / (2 * M_PI) * 65536.0;
+    double atan2_err = check_atan2_range();
+    if (atan2_err > atan2_tol) {
+        fprintf(stderr, "IMU_atan2Fixed: error %.1f units on large inputs (tolerance %.1f)\n", atan2_err, atan2_tol);
+        return 1;
+    }
+    for (int n = 0; n < CASES; n++) {
+        double roll = uniform(-M_PI, M_PI);
+        double pitch = uniform(-85, 85) * M_PI / 180;
+        double yaw = uniform(0, 2 * M_PI);
+        double g = uniform(2000, 16000);       // 1g в LSB для разных диапазонов
+        double f = uniform(100, 400);          // поле в LSB
+        double inc = uniform(0, 1.3);          // наклонение
+
+        // Поле в географических осях (север, восток, вниз) и перевод в связанные оси
+        double wx = f * cos(inc) * cos(yaw), wy = -f * cos(inc) * sin(yaw), wz = f * sin(inc);
+        double cp = cos(pitch), sp = sin(pitch), cr = cos(roll), sr = sin(roll);
+        double tx = cp * wx - sp * wz, tz = sp * wx + cp * wz;
+
+        acc_in[n][0] = (int16_t)lround(-sp * g);
+        acc_in[n][1] = (int16_t)lround(cp * sr * g);
+        acc_in[n][2] = (int16_t)lround(cp * cr * g);
+        mag_in[n][0] = (int16_t)lround(tx);
+        mag_in[n][1] = (int16_t)lround(cr * wy + sr * tz);
+        mag_in[n][2] = (int16_t)lround(-sr * wy + cr * tz);
+    }
+
+    double fixed_err[3] = { 0, 0, 0 }, float_err[3] = { 0, 0, 0 };
+    for (int n = 0; n < CASES; n++) {
+        double h, p, r;
+        reference(acc_in[n], mag_in[n], &h, &p, &r);
+
+        IMU_Heading fx;
+        IMU_computeHeading(acc_in[n], mag_in[n], &fx);
+        fixed_err[0] = fmax(fixed_err[0], angle_error(fx.heading_cdeg / 100.0, h));
+        fixed_err[1] = fmax(fixed_err[1], angle_error(fx.pitch_cdeg / 100.0, p));
+        fixed_err[2] = fmax(fixed_err[2], angle_error(fx.roll_cdeg / 100.0, r));
+
+        float fh, fp, fr;
+        float_heading(acc_in[n], mag_in[n], &fh, &fp, &fr);
+        float_err[0] = fmax(float_err[0], angle_error(fh, h));
+        float_err[1] = fmax(float_err[1], angle_error(fp, p));
+        float_err[2] = fmax(float_err[2], angle_error(fr, r));
+    }
+
+    // Время: результаты суммируются, чтобы компилятор не удалил вычисления
+    volatile long sink = 0;
+    double t0 = wall_seconds();
+    for (int n = 0; n < CASES; n++) {
+        IMU_Heading fx;
+        IMU_computeHeading(acc_in[n], mag_in[n], &fx);
+        sink = sink + fx.heading_cdeg;
+    }
+    double t_fixed = (wall_seconds() - t0) / CASES;
+
+    t0 = wall_seconds();
+    for (int n = 0; n < CASES; n++) {
+        float fh, fp, fr;
+        float_heading(acc_in[n], mag_in[n], &fh, &fp, &fr);
+        sink = sink + (long)fh;
+    }
+    double t_float = (wall_seconds() - t0) / CASES;
+
+    printf("iterations: %d, cases: %d\n", IMU_HEADING_ITERATIONS, CASES);
+    printf("IMU_atan2Fixed, int32 range: max error %.1f units (65536 = turn)\n", atan2_err);
+    printf("max error, deg   heading   pitch     roll\n");
+    printf("fixed (CORDIC)   %-9.4f %-9.4f %-9.4f\n", fixed_err[0], fixed_err[1], fixed_err[2]);
+    printf("float            %-9.4f %-9.4f %-9.4f\n", float_err[0], float_err[1], float_err[2]);
+    printf("time per call: fixed %.0f ns, float %.0f ns (host)\n", t_fixed * 1e9, t_float * 1e9);
+    return 0;
+}
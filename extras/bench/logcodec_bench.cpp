@@ -0,0 +1,127 @@
+/**
+ * @file logcodec_bench.cpp
+ * @brief Бенчмарк сжатого журнала (IMU_LogCodec) на Linux-хосте
+ *
+ * Кодирует синтетическую запись (медленные колебания + шум, 1600 Гц)
+ * в блоки по 512 байт и выводит степень сжатия, стоимость кодирования
+ * (IMU_logCyclesPerSample — на x86-хосте в тактах TSC) и скорость
+ * декодирования.
+ *
+ * Перед выводом все блоки декодируются и сравниваются с исходными
+ * отсчетами; расхождение — код возврата 1.
+ *
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_LogCodec.cpp \
+ *       extras/host/host_arduino.cpp extras/bench/logcodec_bench.cpp -o logcodec_bench
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_LogCodec.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static const uint16_t BLOCK_SIZE = 512;
+static const int SAMPLES = 1000000;
+
+// Поток блоков в памяти
+class MemoryLog : public Print {
+public:
+    std::vector<uint8_t> data;
+    size_t write(uint8_t c) override {
+        data.push_back(c);
+        return 1;
+    }
+    size_t write(const uint8_t* buf, size_t len) override {
+        data.insert(data.end(), buf, buf + len);
+        return len;
+    }
+};
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void make_sample(int i, IMU_Sample* s) {
+    float t = i / 1600.0f;
+    s->t_us = 1000 + (uint32_t)i * 625;
+    for (int a = 0; a < 3; a++) {
+        s->acc[a] = (int16_t)(300.0f * sinf(2.0f * (float)M_PI * (1.0f + a) * t) + (rand() % 17) - 8);
+        s->gyr[a] = (int16_t)(150.0f * sinf(2.0f * (float)M_PI * (0.5f + a) * t) + (rand() % 9) - 4);
+        s->mag[a] = (int16_t)(200 + 40 * a + (rand() % 5) - 2);
+    }
+    s->acc[2] += 8192;
+    s->rhall = 6500;
+}
+
+static bool same_sample(const IMU_Sample& a, const IMU_Sample& b) {
+    return a.t_us == b.t_us && memcmp(a.acc, b.acc, sizeof(a.acc)) == 0 &&
+           memcmp(a.gyr, b.gyr, sizeof(a.gyr)) == 0 && memcmp(a.mag, b.mag, sizeof(a.mag)) == 0 &&
+           a.rhall == b.rhall;
+}
+
+int main() {
+    std::vector<IMU_Sample> input(SAMPLES);
+    for (int i = 0; i < SAMPLES; i++) {
+        make_sample(i, &input[i]);
+    }
+
+    static uint8_t block[BLOCK_SIZE];
+    static IMU_LogEncoder enc;
+    MemoryLog log;
+    if (!IMU_logEncoderInit(&enc, log, block, BLOCK_SIZE)) {
+        fprintf(stderr, "IMU_logEncoderInit failed\n");
+        return 1;
+    }
+    for (int i = 0; i < SAMPLES; i++) {
+        IMU_logAppend(&enc, &input[i]);
+    }
+    IMU_logFlush(&enc);
+
+    // Проверка: декодированные отсчеты совпадают с исходными
+    std::vector<IMU_Sample> out(IMU_LOG_MAX_SAMPLES);
+    size_t nblocks = log.data.size() / BLOCK_SIZE;
+    int total = 0;
+    double decode_time = 0;
+    for (size_t b = 0; b < nblocks; b++) {
+        double t0 = wall_seconds();
+        int n = IMU_logDecodeBlock(&log.data[b * BLOCK_SIZE], BLOCK_SIZE, out.data(), IMU_LOG_MAX_SAMPLES);
+        decode_time += wall_seconds() - t0;
+        if (n < 0) {
+            fprintf(stderr, "block %lu is corrupt\n", (unsigned long)b);
+            return 1;
+        }
+        for (int i = 0; i < n; i++) {
+            if (total + i >= SAMPLES || !same_sample(out[i], input[total + i])) {
+                fprintf(stderr, "sample %d differs after decoding\n", total + i);
+                return 1;
+            }
+        }
+        total += n;
+    }
+    if (total != SAMPLES) {
+        fprintf(stderr, "decoded %d of %d samples\n", total, SAMPLES);
+        return 1;
+    }
+
+    printf("samples: %d, blocks: %lu x %u bytes\n", SAMPLES, (unsigned long)nblocks, BLOCK_SIZE);
+    printf("compression ratio: %.2f (payload), %.2f (file)\n", IMU_logCompressionRatio(&enc),
+           (double)SAMPLES * IMU_LOG_RAW_SAMPLE_SIZE / log.data.size());
+#if defined(__x86_64__) || defined(__i386__)
+    printf("encode: %lu TSC cycles/sample (IMU_logCyclesPerSample)\n",
+           (unsigned long)IMU_logCyclesPerSample(&enc));
+#else
+    printf("encode: cycles/sample unavailable on this host (no TSC)\n");
+#endif
+    printf("decode: %.1f Msamples/s\n", total / decode_time / 1e6);
+    return 0;
+}
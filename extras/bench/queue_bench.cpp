@@ -0,0 +1,123 @@
+/**
+ * @file queue_bench.cpp
+ * @brief Проверка и бенчмарк очереди IMU_Queue на Linux-хосте (std::thread)
+ * 
+ * Производитель и потребитель работают в отдельных потоках:
+ * 1. Без потерь: производитель повторяет запись при полной очереди,
+ *    потребитель проверяет, что все отсчеты пришли по порядку и без искажений
+ * 2. С потерями: производитель не ждет, проверяется, что принятые плюс
+ *    отброшенные равны отправленным, а порядок принятых сохранен
+ * 
+ * Выводит пропускную способность; код возврата 1 при любой ошибке.
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -pthread -I extras/host -I . IMU_Queue.cpp IMU_BMI160_BMM150.cpp \
+ *       IMU_Sched.cpp extras/host/host_arduino.cpp extras/bench/queue_bench.cpp -o queue_bench
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_Queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <thread>
+
+static const uint32_t COUNT = 20000000;
+static const uint16_t CAPACITY = 256;
+static const size_t BATCH = 16;
+
+static IMU_Sample buf[CAPACITY];
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Отсчет с порядковым номером; остальные поля выводятся из номера для проверки целостности
+static void make_sample(uint32_t seq, IMU_Sample* s) {
+    s->t_us = seq;
+    for (int i = 0; i < 3; i++) {
+        s->acc[i] = (int16_t)(seq * 3 + i);
+        s->gyr[i] = (int16_t)(seq * 5 + i);
+        s->mag[i] = (int16_t)(seq * 7 + i);
+    }
+    s->rhall = (int16_t)(seq >> 16);
+}
+
+static bool check_sample(const IMU_Sample* s) {
+    IMU_Sample ref;
+    make_sample(s->t_us, &ref);
+    return memcmp(s, &ref, sizeof(ref)) == 0;
+}
+
+/**
+ * @brief Один прогон: производитель и потребитель в разных потоках
+ * 
+ * @param lossless true — производитель ждет освобождения места
+ * @return Количество ошибок
+ */
+static unsigned long run(bool lossless) {
+    IMU_Queue q;
+    IMU_queueInit(&q, buf, CAPACITY);
+    volatile bool done = false;
+    unsigned long errors = 0, received = 0;
+
+    double t0 = wall_seconds();
+    std::thread producer([&]() {
+        IMU_Sample s;
+        for (uint32_t seq = 0; seq < COUNT; seq++) {
+            make_sample(seq, &s);
+            while (!IMU_queuePush(&q, &s) && lossless) {
+                std::this_thread::yield();
+            }
+        }
+        __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    });
+    std::thread consumer([&]() {
+        IMU_Sample out[BATCH];
+        long last = -1;
+        for (;;) {
+            bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+            size_t n = IMU_queuePopBatch(&q, out, BATCH);
+            for (size_t i = 0; i < n; i++) {
+                long seq = (long)out[i].t_us;
+                bool ordered = lossless ? seq == last + 1 : seq > last;
+                if (!ordered || !check_sample(&out[i])) {
+                    errors++;
+                }
+                last = seq;
+            }
+            received += n;
+            if (n == 0) {
+                if (finished) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+    double dt = wall_seconds() - t0;
+
+    uint32_t overruns = IMU_queueOverruns(&q);
+    // Без потерь счетчик переполнений считает повторные попытки записи
+    if (lossless ? received != COUNT : received + overruns != COUNT) {
+        errors++;
+    }
+    printf("%-9s sent %lu, received %lu, overruns %lu, errors %lu, %.1f Msamples/s\n",
+           lossless ? "lossless" : "lossy", (unsigned long)COUNT, received,
+           (unsigned long)overruns, errors, COUNT / dt / 1e6);
+    return errors;
+}
+
+int main() {
+    unsigned long errors = run(true) + run(false);
+    printf(errors ? "FAIL\n" : "OK\n");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file spectrum_bench.cpp
+ * @brief Бенчмарк спектрального анализа (IMU_Spectrum) на Linux-хосте
+ * 
+ * Подает синтетический сигнал вибрации (два тона + шум) и измеряет время
+ * анализа одного блока (3 оси: окно, БПФ, полосы, пик, Гёрцель).
+ * 
+ * Перед замером проверяется СКЗ на полной шкале: меандр ±30000 (СКЗ 30000)
+ * и синус с амплитудой 12000 (СКЗ 8485); расхождение больше 0.5% — код
+ * возврата 1.
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_Spectrum.cpp \
+ *       extras/host/host_arduino.cpp extras/bench/spectrum_bench.cpp -o spectrum_bench
+ * 
+ * Для оценки на другой длине блока добавьте -DIMU_SPECTRUM_N=256 и т.п.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_Spectrum.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+/**
+ * @brief Подает блок полной шкалы и сравнивает СКЗ оси x с ожидаемым
+ */
+static bool check_rms(const char* name, bool square, float amplitude, float expected) {
+    static IMU_Spectrum sp;
+    IMU_spectrumInit(&sp, 1600.0f, IMU_SPECTRUM_N);
+    for (int i = 0; i < IMU_SPECTRUM_N; i++) {
+        // Целое число периодов в блоке: среднее 0
+        float phase = 2.0f * (float)M_PI * 4.0f * i / IMU_SPECTRUM_N;
+        float v = square ? (i % 16 < 8 ? amplitude : -amplitude) : amplitude * sinf(phase);
+        int16_t acc[3] = { (int16_t)lrintf(v), 0, 0 };
+        IMU_spectrumPush(&sp, acc);
+    }
+    float rms = sp.axis[0].rms;
+    bool ok = sp.blocks == 1 && fabsf(rms - expected) <= expected * 0.005f;
+    printf("full scale %s: rms %.1f, expected %.1f%s\n", name, rms, expected, ok ? "" : "  FAIL");
+    return ok;
+}
+
+static double wall_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main() {
+    bool rms_ok = check_rms("square 30000", true, 30000.0f, 30000.0f);
+    rms_ok = check_rms("sine 12000", false, 12000.0f, 12000.0f / sqrtf(2.0f)) && rms_ok;
+    if (!rms_ok) {
+        return 1;
+    }
+
+    static IMU_Spectrum sp;
+    const float fs = 1600.0f;
+    IMU_spectrumInit(&sp, fs, IMU_SPECTRUM_N / 2);
+    IMU_spectrumAddBand(&sp, 10, 100);
+    IMU_spectrumAddBand(&sp, 100, 300);
+    IMU_spectrumAddBand(&sp, 300, 800);
+    IMU_spectrumAddFrequency(&sp, 50);
+    IMU_spectrumAddFrequency(&sp, 120);
+
+    // Сигнал генерируется заранее, чтобы измерять только анализ
+    const int period = 16000;
+    static int16_t signal[period][3];
+    srand(1);
+    for (int i = 0; i < period; i++) {
+        float t = (float)i / fs;
+        for (int a = 0; a < 3; a++) {
+            signal[i][a] = (int16_t)(1200.0f * sinf(2.0f * (float)M_PI * (50.0f + 10 * a) * t) +
+                                     400.0f * sinf(2.0f * (float)M_PI * 237.0f * t) + (rand() % 65) - 32);
+        }
+        signal[i][2] += 8192;
+    }
+
+    const long samples = 2000000;
+    double t0 = wall_ns();
+#ifdef HAVE_TSC
+    unsigned long long c0 = __rdtsc();
+#endif
+    for (long i = 0; i < samples; i++) {
+        IMU_spectrumPush(&sp, signal[i % period]);
+    }
+#ifdef HAVE_TSC
+    unsigned long long cycles = __rdtsc() - c0;
+#endif
+    double ns = wall_ns() - t0;
+
+    printf("block: N=%d hop=%u, blocks=%lu\n", IMU_SPECTRUM_N, sp.hop, (unsigned long)sp.blocks);
+    printf("time per block (3 axes, incl. input): %.0f ns\n", ns / sp.blocks);
+#ifdef HAVE_TSC
+    printf("TSC cycles per block: %.0f\n", (double)cycles / sp.blocks);
+#endif
+    printf("input rate capacity: %.0f ksamples/s\n", samples / ns * 1e6);
+    printf("last block, axis x: rms %.1f, peak %.1f Hz\n", sp.axis[0].rms, sp.axis[0].peak_hz);
+    return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file view_bench.cpp
+ * @brief Сравнение чтения в массивы и чтения через IMU_SampleView на Linux-хосте
+ *
+ * Драйвер инициализируется на модели регистров (extras/host/imu_model.h,
+ * BMM150 за BMI160), а замеры идут на плоской шине: чтение копирует байты
+ * из снимка регистров модели. Время — только CPU драйвера и потребителя.
+ * Для каждой маски каналов сравниваются IMU_readChannels(mask) и
+ * IMU_readView(mask), плюс IMU_readDataWithFrequency() против
+ * IMU_pollSensorsView() на 1600 Гц (каждый вызов — очередной срок).
+ * Потребитель использует одно значение канала (для ALL — ось z гироскопа)
+ * или, в строке "all fields", все 10 значений.
+ *
+ * Оба пути читают один и тот же пакет (столбец "bus B" — байт на вызов),
+ * поэтому разница — только разбор и копирование значений, которые
+ * потребитель не использует: единицы наносекунд на хосте. Замеры
+ * чередуются (копия, view, копия, ...), берется лучший из RUNS прогонов.
+ * Строка "control" сравнивает копию с ней же: отношения в пределах ее
+ * отклонения от 1.00x не значимы.
+ *
+ * Перед замером проверяется, что оси из IMU_SampleView совпадают с
+ * массивами IMU_readData() и что оба пути читают одинаковое число байт;
+ * код возврата 1 при расхождении.
+ *
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_BMI160_BMM150.cpp IMU_Sched.cpp \
+ *       extras/host/host_arduino.cpp extras/bench/view_bench.cpp -o view_bench
+ *
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+#include "imu_model.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const int CALLS = 200000;
+static const int RUNS = 11;
+
+// Период опроса 1600 Гц (мкс, с округлением вверх — каждый вызов в срок)
+static const uint32_t PERIOD_1600_US = 625;
+
+static volatile int32_t sink;
+
+// Снимок регистров BMI160 0x00-0x7F после IMU_begin() на модели
+static uint8_t flat_regs[128];
+static unsigned long flat_bytes = 0;
+
+static bool flat_probe(uint8_t, uint8_t) {
+    return true;
+}
+
+static bool flat_write(uint8_t, uint8_t, const uint8_t*, uint8_t) {
+    return true;
+}
+
+static bool flat_read(uint8_t, uint8_t reg, uint8_t* buf, uint8_t len) {
+    memcpy(buf, &flat_regs[reg & 0x7F], len);
+    flat_bytes += len;
+    return true;
+}
+
+static const IMU_Bus flat_bus = { flat_probe, flat_write, flat_read };
+
+// Сценарий: маска каналов и сколько значений использует потребитель
+struct Case {
+    const char* name;
+    uint8_t mask;
+    bool all_fields;
+};
+
+static const Case cases[] = {
+    { "ACC", IMU_CHANNEL_ACC, false },
+    { "GYR", IMU_CHANNEL_GYR, false },
+    { "MAG", IMU_CHANNEL_MAG, false },
+    { "ALL", IMU_CHANNEL_ALL, false },
+    { "ALL, all fields", IMU_CHANNEL_ALL, true },
+};
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool view_matches_arrays() {
+    int16_t acc[3], gyr[3], mag[3], rhall;
+    IMU_readData(acc, gyr, mag, &rhall);
+    // Повторное чтение не нужно: буфер отсчета хранит пакет последнего чтения
+    const IMU_SampleView* v = IMU_readView(0);
+    for (uint8_t i = 0; i < 3; i++) {
+        if (IMU_viewAcc(v, i) != acc[i] || IMU_viewGyr(v, i) != gyr[i] || IMU_viewMag(v, i) != mag[i]) {
+            return false;
+        }
+    }
+    return IMU_viewRhall(v) == rhall;
+}
+
+/**
+ * @brief Значение, которое использует потребитель, из массивов
+ */
+static int32_t use_arrays(const Case& c, const int16_t* acc, const int16_t* gyr, const int16_t* mag, int16_t rhall) {
+    if (c.all_fields) {
+        return acc[0] + acc[1] + acc[2] + gyr[0] + gyr[1] + gyr[2] + mag[0] + mag[1] + mag[2] + rhall;
+    }
+    return c.mask == IMU_CHANNEL_ACC ? acc[2] : c.mask == IMU_CHANNEL_MAG ? mag[0] : gyr[2];
+}
+
+/**
+ * @brief То же значение из IMU_SampleView
+ */
+static int32_t use_view(const Case& c, const IMU_SampleView* v) {
+    if (c.all_fields) {
+        return IMU_viewAcc(v, 0) + IMU_viewAcc(v, 1) + IMU_viewAcc(v, 2) +
+               IMU_viewGyr(v, 0) + IMU_viewGyr(v, 1) + IMU_viewGyr(v, 2) +
+               IMU_viewMag(v, 0) + IMU_viewMag(v, 1) + IMU_viewMag(v, 2) + IMU_viewRhall(v);
+    }
+    return c.mask == IMU_CHANNEL_ACC ? IMU_viewAcc(v, 2) : c.mask == IMU_CHANNEL_MAG ? IMU_viewMag(v, 0) : IMU_viewGyr(v, 2);
+}
+
+static double ns_copy(const Case& c) {
+    int16_t acc[3], gyr[3], mag[3], rhall;
+    int32_t sum = 0;
+    double w0 = wall_seconds();
+    for (int i = 0; i < CALLS; i++) {
+        IMU_readChannels(c.mask, acc, gyr, mag, &rhall);
+        sum += use_arrays(c, acc, gyr, mag, rhall);
+    }
+    sink = sum;
+    return (wall_seconds() - w0) / CALLS * 1e9;
+}
+
+static double ns_view(const Case& c) {
+    int32_t sum = 0;
+    double w0 = wall_seconds();
+    for (int i = 0; i < CALLS; i++) {
+        sum += use_view(c, IMU_readView(c.mask));
+    }
+    sink = sum;
+    return (wall_seconds() - w0) / CALLS * 1e9;
+}
+
+static double ns_read_frequency(const Case&) {
+    int16_t acc[3], gyr[3], mag[3], rhall;
+    int32_t sum = 0;
+    double w0 = wall_seconds();
+    for (int i = 0; i < CALLS; i++) {
+        IMU_readDataWithFrequency(acc, gyr, mag, &rhall, 1600.0f);
+        sum += gyr[2];
+        host_advanceMicros(PERIOD_1600_US);
+    }
+    sink = sum;
+    return (wall_seconds() - w0) / CALLS * 1e9;
+}
+
+static double ns_poll_view(const Case&) {
+    int32_t sum = 0;
+    double w0 = wall_seconds();
+    for (int i = 0; i < CALLS; i++) {
+        const IMU_SampleView* v = IMU_pollSensorsView();
+        if (v->updated & IMU_CHANNEL_GYR) {
+            sum += IMU_viewGyr(v, 2);
+        }
+        host_advanceMicros(PERIOD_1600_US);
+    }
+    sink = sum;
+    return (wall_seconds() - w0) / CALLS * 1e9;
+}
+
+/**
+ * @brief Байт на шине за один вызов copy и view
+ */
+static bool same_bus_bytes(const Case& c, unsigned long* bytes) {
+    int16_t acc[3], gyr[3], mag[3], rhall;
+    flat_bytes = 0;
+    IMU_readChannels(c.mask, acc, gyr, mag, &rhall);
+    *bytes = flat_bytes;
+    flat_bytes = 0;
+    IMU_readView(c.mask);
+    return flat_bytes == *bytes;
+}
+
+/**
+ * @brief Лучшее время из RUNS прогонов; прогоны двух вариантов чередуются
+ */
+static void measure(double (*copy)(const Case&), double (*view)(const Case&), const Case& c,
+                    double* copy_ns, double* view_ns) {
+    *copy_ns = copy(c);
+    *view_ns = view(c);
+    for (int r = 1; r < RUNS; r++) {
+        double ns = copy(c);
+        if (ns < *copy_ns) {
+            *copy_ns = ns;
+        }
+        ns = view(c);
+        if (ns < *view_ns) {
+            *view_ns = ns;
+        }
+    }
+}
+
+static void report(const char* name, const char* bus, double copy_ns, double view_ns) {
+    printf("%-34s %6s %9.1f %9.1f %7.2fx\n", name, bus, copy_ns, view_ns, copy_ns / view_ns);
+}
+
+int main() {
+    imu_model_init(true, false, true, 23);
+    IMU_setBus(&imu_model_bus);
+    host_setMicros(1000);
+    if (!IMU_begin() || IMU_getMagMode() != SECONDARY) {
+        fprintf(stderr, "IMU_begin failed on the model\n");
+        return 1;
+    }
+    if (!view_matches_arrays()) {
+        fprintf(stderr, "IMU_SampleView does not match IMU_readData\n");
+        return 1;
+    }
+
+    imu_model_read(0x68, 0x00, flat_regs, sizeof(flat_regs));
+    IMU_setBus(&flat_bus);
+    IMU_setPollRates(1600.0f, 0);
+    printf("%-34s %6s %9s %9s %8s\n", "IMU_readChannels vs IMU_readView", "bus B", "copy ns", "view ns", "copy/view");
+    for (const Case& c : cases) {
+        unsigned long bytes;
+        if (!same_bus_bytes(c, &bytes)) {
+            fprintf(stderr, "%s: IMU_readView reads a different packet than IMU_readChannels\n", c.name);
+            return 1;
+        }
+        char bus[16];
+        snprintf(bus, sizeof(bus), "%lu", bytes);
+        double copy_ns, view_ns;
+        measure(ns_copy, ns_view, c, &copy_ns, &view_ns);
+        report(c.name, bus, copy_ns, view_ns);
+    }
+    double copy_ns, view_ns;
+    measure(ns_read_frequency, ns_poll_view, cases[3], &copy_ns, &view_ns);
+    report("readDataWithFrequency vs pollView", "-", copy_ns, view_ns);
+    // Контроль: одна и та же функция в обоих столбцах — разброс замера
+    measure(ns_copy, ns_copy, cases[3], &copy_ns, &view_ns);
+    report("control: ALL copy vs copy", "-", copy_ns, view_ns);
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file Arduino.h
+ * @brief Минимальная прослойка Arduino API для сборки библиотеки на Linux-хосте
+ *
+ * Позволяет собрать IMU_BMI160_BMM150 и её модули обычным g++ без Arduino IDE:
+ * - виртуальные часы delay()/millis()/micros() (время идет только через delay()
+ *   или явную установку host_setMicros(), поэтому прогон детерминирован)
+ * - Serial пишет в stdout
+ * - F() и PROGMEM — пустые обертки
+ *
+ * Используется инструментами из extras/ (воспроизведение записей, бенчмарки).
+ * В прошивку не попадает: Arduino IDE не компилирует каталог extras/.
+ *
+ * @author AXIOMICA
+ */
+
+#ifndef IMU_HOST_ARDUINO_H
+#define IMU_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P(dst, src, n) memcpy((dst), (src), (n))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// Виртуальные часы хоста
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+void host_setMicros(uint32_t us);
+void host_advanceMicros(uint32_t us);
+
+// Вывод (подмножество Print из ядра Arduino)
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (len--) n += write(*buf++);
+        return n;
+    }
+
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const __FlashStringHelper* s) { return print((const char*)s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(double v, int digits = 2);
+
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t len);
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // IMU_HOST_ARDUINO_H
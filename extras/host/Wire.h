@@ -0,0 +1,31 @@
+/**
+ * @file Wire.h
+ * @brief Заглушка TwoWire для сборки на Linux-хосте
+ *
+ * На хосте физической шины нет: любая транзакция завершается NACK.
+ * Для работы с данными подключите свою шину через IMU_setBus()
+ * (воспроизведение записи, модель регистров и т.п.).
+ *
+ * @author AXIOMICA
+ */
+
+#ifndef IMU_HOST_WIRE_H
+#define IMU_HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission(bool = true) { return 2; }
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // IMU_HOST_WIRE_H
@@ -0,0 +1,59 @@
+/**
+ * @file host_arduino.cpp
+ * @brief Реализация прослойки Arduino API для Linux-хоста
+ *
+ * @author AXIOMICA
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <stdio.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static uint32_t host_us = 0;
+
+void delay(unsigned long ms) { host_us += (uint32_t)ms * 1000UL; }
+void delayMicroseconds(unsigned int us) { host_us += us; }
+unsigned long millis() { return host_us / 1000UL; }
+unsigned long micros() { return host_us; }
+void host_setMicros(uint32_t us) { host_us = us; }
+void host_advanceMicros(uint32_t us) { host_us += us; }
+
+size_t Print::print(long v, int base) {
+    size_t n = 0;
+    if (v < 0 && base == DEC) {
+        n += print('-');
+        return n + print((unsigned long)(-v), base);
+    }
+    return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+    char buf[33];
+    char* p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if (base < 2) base = DEC;
+    do {
+        unsigned long d = v % (unsigned long)base;
+        *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+        v /= (unsigned long)base;
+    } while (v);
+    return print(p);
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return print(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+    return fwrite(buf, 1, len, stdout);
+}
@@ -0,0 +1,276 @@
+/**
+ * @file imu_model.h
+ * @brief Модель регистров BMI160 и BMM150 для прогона драйвера на Linux-хосте
+ * 
+ * Подключается через IMU_setBus(&imu_model_bus) и отвечает на транзакции
+ * драйвера как настоящие датчики, без записи с железа:
+ * - BMI160: Chip ID, Soft Reset, команды включения ACC/GYR/MAG и PMU_STATUS,
+ *   STATUS (данные всегда готовы; mag_man_op занят на время обмена
+ *   по вторичной шине), пакет данных DATA_0..DATA_19. Пакетная запись,
+ *   пока акселерометр и гироскоп в suspend, отвергается (настоящий датчик
+ *   молча теряет такие байты)
+ * - BMM150 на основной шине: питание, Chip ID (только после включения), данные
+ * - BMM150 за BMI160: ручные запись/чтение через MAG_IF и пакет данных MAG
+ *   в DATA_0..DATA_7 после включения магнитометра. Протокол проверяется:
+ *   BMM150 отвечает только по адресу MAG_IF_0 (биты 7:1), только при
+ *   включенном интерфейсе (IF_CONF, бит 5) и mag_pmu; запись запускается
+ *   записью MAG_IF_3 с данными из MAG_IF_4, чтение — записью MAG_IF_2
+ *   с длиной пакета из MAG_IF_1. Запись MAG_IF_0..MAG_IF_4, пока ручная
+ *   операция не закончилась (mag_man_op), отвергается
+ * 
+ * Сценарий задается полями imu_model перед IMU_begin(). Каждая транзакция
+ * продвигает виртуальные часы на время передачи по шине (byte_us на байт,
+ * подсчет байт как в IMU_BusStats), поэтому micros() отражает и паузы
+ * драйвера, и время обмена.
+ * 
+ * Заголовочный модуль: подключается в одну единицу трансляции инструмента.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#ifndef IMU_HOST_MODEL_H
+#define IMU_HOST_MODEL_H
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+
+struct ImuModel {
+    bool bmi160;            // BMI160 на адресе 0x68
+    bool bmm150_primary;    // BMM150 на основной шине (bmm150_addr)
+    bool bmm150_aux;        // BMM150 на вторичной шине BMI160
+    uint8_t bmm150_addr;    // Адрес BMM150 на основной шине
+    uint8_t bmm150_aux_addr; // Адрес BMM150 на вторичной шине
+    uint32_t aux_busy_until; // Окончание ручной операции вторичного интерфейса (micros)
+    uint32_t byte_us;       // Время передачи одного байта (мкс); 0 — мгновенная шина
+    uint8_t bmi[128];       // Регистры BMI160
+    uint8_t bmm[128];       // Регистры BMM150
+};
+
+static ImuModel imu_model;
+
+// Значения, которые отдают датчики (LSB)
+static const int16_t imu_model_acc[3] = { 120, -340, 8190 };
+static const int16_t imu_model_gyr[3] = { 15, -7, 3 };
+static const int16_t imu_model_mag[3] = { 210, -95, -410 };
+static const int16_t imu_model_rhall = 6620;
+
+static void imu_model_put16(uint8_t* p, int16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+static void imu_model_bmi_reset() {
+    memset(imu_model.bmi, 0, sizeof(imu_model.bmi));
+    imu_model.bmi[0x00] = 0xD1;
+    imu_model.bmi[0x40] = 0x28;
+    imu_model.bmi[0x41] = 0x03;
+    imu_model.bmi[0x42] = 0x28;
+}
+
+static void imu_model_bmm_reset() {
+    memset(imu_model.bmm, 0, sizeof(imu_model.bmm));
+}
+
+/**
+ * @brief Заполняет регистры данных BMM150 (0x42..0x49) в формате датчика
+ */
+static void imu_model_bmm_data() {
+    uint8_t* d = &imu_model.bmm[0x42];
+    imu_model_put16(&d[0], (int16_t)(imu_model_mag[0] * 8));
+    imu_model_put16(&d[2], (int16_t)(imu_model_mag[1] * 8));
+    imu_model_put16(&d[4], (int16_t)(imu_model_mag[2] * 2));
+    imu_model_put16(&d[6], imu_model_rhall);
+}
+
+static bool imu_model_bmm_powered() {
+    return (imu_model.bmm[0x4B] & 0x01) != 0;
+}
+
+/**
+ * @brief Чтение регистра BMM150 (Chip ID в режиме suspend не отвечает)
+ */
+static uint8_t imu_model_bmm_read(uint8_t reg) {
+    if (!imu_model_bmm_powered()) {
+        return 0;
+    }
+    if (reg == 0x40) {
+        return 0x32;
+    }
+    imu_model_bmm_data();
+    return imu_model.bmm[reg & 0x7F];
+}
+
+static void imu_model_bmm_write(uint8_t reg, uint8_t val) {
+    if (reg == 0x4B && (val & 0x82) == 0x82) {
+        imu_model_bmm_reset();
+        imu_model.bmm[0x4B] = val & 0x01;
+        return;
+    }
+    imu_model.bmm[reg & 0x7F] = val;
+}
+
+static bool imu_model_aux_ready() {
+    return imu_model.bmm150_aux && (imu_model.bmi[0x6B] & 0x20) &&
+           (imu_model.bmi[0x03] & 0x03) == 0x01 &&
+           (imu_model.bmi[0x4B] >> 1) == imu_model.bmm150_aux_addr;
+}
+
+static bool imu_model_mag_running() {
+    return imu_model_aux_ready() && imu_model_bmm_powered();
+}
+
+/**
+ * @brief Занимает вторичный интерфейс на время обмена bytes байт (~1 МГц)
+ */
+static void imu_model_aux_busy(uint8_t bytes) {
+    imu_model.aux_busy_until = micros() + 20 + 10UL * bytes;
+}
+
+static bool imu_model_aux_busy_now() {
+    return (int32_t)(micros() - imu_model.aux_busy_until) < 0;
+}
+
+/**
+ * @brief Чтение регистра BMI160 с учетом состояния модели
+ */
+static uint8_t imu_model_bmi_read(uint8_t reg) {
+    uint8_t* r = imu_model.bmi;
+    if (reg >= 0x04 && reg <= 0x17) {
+        uint8_t d[20];
+        memset(d, 0, sizeof(d));
+        if (imu_model_mag_running() && !(r[0x4C] & 0x80)) {
+            // Режим данных: пакет с адреса MAG_IF_2 вторичного датчика
+            for (uint8_t i = 0; i < 8; i++) {
+                d[i] = imu_model_bmm_read((uint8_t)(r[0x4D] + i));
+            }
+        } else {
+            memcpy(d, &r[0x04], 8);
+        }
+        if (r[0x03] & 0x0C) {
+            for (uint8_t i = 0; i < 3; i++) imu_model_put16(&d[8 + 2 * i], imu_model_gyr[i]);
+        }
+        if (r[0x03] & 0x30) {
+            for (uint8_t i = 0; i < 3; i++) imu_model_put16(&d[14 + 2 * i], imu_model_acc[i]);
+        }
+        return d[reg - 0x04];
+    }
+    if (reg == 0x1B) {
+        // drdy_acc, drdy_gyr, drdy_mag; mag_man_op (бит 2) — идет ручная операция
+        uint8_t st = 0;
+        if (r[0x03] & 0x30) st |= 0x80;
+        if (r[0x03] & 0x0C) st |= 0x40;
+        if (imu_model_mag_running()) st |= 0x20;
+        if (imu_model_aux_busy_now()) st |= 0x04;
+        return st;
+    }
+    return r[reg & 0x7F];
+}
+
+static void imu_model_bmi_write(uint8_t reg, uint8_t val) {
+    uint8_t* r = imu_model.bmi;
+    if (reg == 0x7E) {
+        switch (val) {
+            case 0xB6: imu_model_bmi_reset(); break;
+            case 0x11: r[0x03] = (uint8_t)((r[0x03] & ~0x30) | 0x10); break;
+            case 0x15: r[0x03] = (uint8_t)((r[0x03] & ~0x0C) | 0x04); break;
+            case 0x19: r[0x03] = (uint8_t)((r[0x03] & ~0x03) | 0x01); break;
+        }
+        return;
+    }
+    r[reg & 0x7F] = val;
+    if (!imu_model_aux_ready() || !(r[0x4C] & 0x80)) {
+        return;
+    }
+    // Ручной режим вторичного интерфейса
+    if (reg == 0x4E) {
+        imu_model_bmm_write(val, r[0x4F]);
+        imu_model_aux_busy(3);
+    } else if (reg == 0x4D) {
+        static const uint8_t burst[4] = { 1, 2, 6, 8 };
+        uint8_t len = burst[r[0x4C] & 0x03];
+        for (uint8_t i = 0; i < len; i++) {
+            r[0x04 + i] = imu_model_bmm_read((uint8_t)(val + i));
+        }
+        imu_model_aux_busy((uint8_t)(2 + len));
+    }
+}
+
+static void imu_model_charge(uint8_t bytes) {
+    host_advanceMicros(imu_model.byte_us * bytes);
+}
+
+static bool imu_model_present(uint8_t addr) {
+    return (addr == 0x68 && imu_model.bmi160) ||
+           (imu_model.bmm150_primary && addr == imu_model.bmm150_addr);
+}
+
+static bool imu_model_probe(uint8_t addr, uint8_t reg) {
+    (void)reg;
+    imu_model_charge(2);
+    return imu_model_present(addr);
+}
+
+/**
+ * @brief BMI160 принимает пакетную запись: акселерометр или гироскоп в normal
+ */
+static bool imu_model_bmi_burst_ok() {
+    return (imu_model.bmi[0x03] & 0x30) == 0x10 || (imu_model.bmi[0x03] & 0x0C) == 0x04;
+}
+
+static bool imu_model_write(uint8_t addr, uint8_t reg, const uint8_t* data, uint8_t len) {
+    imu_model_charge((uint8_t)(2 + len));
+    if (!imu_model_present(addr)) {
+        return false;
+    }
+    if (addr == 0x68 && len > 1 && !imu_model_bmi_burst_ok()) {
+        return false;
+    }
+    if (addr == 0x68 && reg <= 0x4F && reg + len > 0x4B && imu_model_aux_busy_now()) {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        if (addr == 0x68) {
+            imu_model_bmi_write((uint8_t)(reg + i), data[i]);
+        } else {
+            imu_model_bmm_write((uint8_t)(reg + i), data[i]);
+        }
+    }
+    return true;
+}
+
+static bool imu_model_read(uint8_t addr, uint8_t reg, uint8_t* buf, uint8_t len) {
+    imu_model_charge((uint8_t)(3 + len));
+    if (!imu_model_present(addr)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+        buf[i] = addr == 0x68 ? imu_model_bmi_read(r) : imu_model_bmm_read(r);
+    }
+    return true;
+}
+
+static const IMU_Bus imu_model_bus = { imu_model_probe, imu_model_write, imu_model_read };
+
+/**
+ * @brief Сбрасывает модель в состояние после подачи питания
+ * 
+ * @param bmi160 BMI160 присутствует
+ * @param bmm150_primary BMM150 на основной шине (адрес 0x10)
+ * @param bmm150_aux BMM150 на вторичной шине BMI160
+ * @param byte_us Время передачи байта (мкс), 23 ≈ 400 кГц
+ */
+static void imu_model_init(bool bmi160, bool bmm150_primary, bool bmm150_aux, uint32_t byte_us) {
+    imu_model.bmi160 = bmi160;
+    imu_model.bmm150_primary = bmm150_primary;
+    imu_model.bmm150_aux = bmm150_aux;
+    imu_model.bmm150_addr = 0x10;
+    imu_model.bmm150_aux_addr = 0x10;
+    imu_model.aux_busy_until = micros();
+    imu_model.byte_us = byte_us;
+    imu_model_bmi_reset();
+    imu_model_bmm_reset();
+}
+
+#endif // IMU_HOST_MODEL_H
@@ -0,0 +1,120 @@
+/**
+ * @file imu_logdecode.cpp
+ * @brief Декодирование сжатого журнала IMU (IMU_LogCodec) на Linux-хосте
+ * 
+ * Читает файл из блоков фиксированного размера и выводит отсчеты в stdout
+ * в формате TSV: время (мкс), acc[3], gyr[3], mag[3], rhall. Сводка
+ * (количество блоков, степень сжатия, скорость декодирования) — в stderr.
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_LogCodec.cpp \
+ *       extras/host/host_arduino.cpp extras/logdecode/imu_logdecode.cpp -o imu_logdecode
+ * 
+ * Использование:
+ *   ./imu_logdecode log.bin [block_size] > samples.tsv
+ *   ./imu_logdecode log.bin 512 --from 120000000   # с блока, содержащего t >= 120 с
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_LogCodec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s log.bin [block_size] [--from t_us]\n", argv[0]);
+        return 2;
+    }
+    uint16_t block_size = argc > 2 ? (uint16_t)atoi(argv[2]) : 512;
+    uint32_t from_us = 0;
+    if (argc > 4 && strcmp(argv[3], "--from") == 0) {
+        from_us = (uint32_t)strtoul(argv[4], nullptr, 10);
+    }
+
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<uint8_t> data(size > 0 ? (size_t)size : 0);
+    if (fread(data.data(), 1, data.size(), f) != data.size()) {
+        fprintf(stderr, "short read on %s\n", argv[1]);
+        fclose(f);
+        return 2;
+    }
+    fclose(f);
+
+    size_t nblocks = data.size() / block_size;
+
+    // Поиск первого блока по времени: блоки идут по возрастанию времени,
+    // поэтому достаточно двоичного поиска по заголовкам
+    size_t first = 0;
+    if (from_us) {
+        size_t lo = 0, hi = nblocks;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            IMU_LogBlockInfo info;
+            if (IMU_logBlockInfo(&data[mid * block_size], block_size, &info) && info.t0_us <= from_us) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        first = lo > 0 ? lo - 1 : 0;
+    }
+
+    std::vector<IMU_Sample> samples(IMU_LOG_MAX_SAMPLES);
+    unsigned long total = 0, corrupt = 0;
+    uint64_t payload = 0;
+    double decode_time = 0;
+
+    for (size_t b = first; b < nblocks; b++) {
+        const uint8_t* block = &data[b * block_size];
+        double t0 = wall_seconds();
+        int n = IMU_logDecodeBlock(block, block_size, samples.data(), IMU_LOG_MAX_SAMPLES);
+        decode_time += wall_seconds() - t0;
+        if (n < 0) {
+            corrupt++;
+            continue;
+        }
+        payload += ((uint64_t)block[5] << 8) | block[4];
+        for (int i = 0; i < n; i++) {
+            const IMU_Sample& s = samples[i];
+            if (s.t_us < from_us) {
+                continue;
+            }
+            printf("%lu\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n", (unsigned long)s.t_us,
+                   s.acc[0], s.acc[1], s.acc[2], s.gyr[0], s.gyr[1], s.gyr[2],
+                   s.mag[0], s.mag[1], s.mag[2], s.rhall);
+        }
+        total += n;
+    }
+
+    fprintf(stderr, "blocks: %lu (corrupt: %lu)\n", (unsigned long)(nblocks - first), corrupt);
+    fprintf(stderr, "samples: %lu\n", total);
+    if (payload) {
+        fprintf(stderr, "compression ratio: %.2f (payload), %.2f (file)\n",
+                (double)total * IMU_LOG_RAW_SAMPLE_SIZE / payload,
+                (double)total * IMU_LOG_RAW_SAMPLE_SIZE / ((nblocks - first) * (double)block_size));
+    }
+    if (decode_time > 0) {
+        fprintf(stderr, "decode: %.1f Msamples/s\n", total / decode_time / 1e6);
+    }
+    return corrupt ? 1 : 0;
+}
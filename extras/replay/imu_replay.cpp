@@ -0,0 +1,92 @@
+/**
+ * @file imu_replay.cpp
+ * @brief Воспроизведение записи трафика IMU на Linux-хосте
+ * 
+ * Прогоняет запись, сделанную через IMU_captureBegin(), через тот же код
+ * драйвера: IMU_begin() и затем IMU_readData() до конца записи. Результат
+ * выводится в stdout в формате скетча (время и сырые значения), сводка —
+ * в stderr. Два прогона одной записи дают побайтно одинаковый вывод, поэтому
+ * изменения декодирования и обработки можно сравнивать с полевыми данными.
+ * 
+ * Сборка (из корня библиотеки):
+ *   g++ -O2 -std=gnu++11 -I extras/host -I . IMU_BMI160_BMM150.cpp IMU_Sched.cpp IMU_Capture.cpp \
+ *       extras/host/host_arduino.cpp extras/replay/imu_replay.cpp -o imu_replay
+ * 
+ * Использование:
+ *   ./imu_replay capture.bin > samples.tsv
+ * 
+ * @note Запись должна начинаться до IMU_begin(), иначе драйвер не найдет датчики
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <Arduino.h>
+#include "IMU_BMI160_BMM150.h"
+#include "IMU_Capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+static bool load_file(const char* path, std::vector<uint8_t>* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        out->insert(out->end(), chunk, chunk + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s capture.bin\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!load_file(argv[1], &data)) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    if (!IMU_replayBegin(data.data(), data.size(), host_setMicros)) {
+        fprintf(stderr, "%s: not an IMU capture (version %d expected)\n", argv[1], IMU_CAPTURE_VERSION);
+        return 2;
+    }
+    IMU_setBus(IMU_replayBus());
+
+    double t0 = wall_seconds();
+    IMU_begin();
+
+    unsigned long samples = 0;
+    while (!IMU_replayDone()) {
+        int16_t acc[3], gyr[3], mag[3], rhall;
+        IMU_readData(acc, gyr, mag, &rhall);
+        if (IMU_replayUnderrun()) {
+            break; // Запись закончилась посреди последнего чтения
+        }
+        printf("%lu\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n", millis(),
+               acc[0], acc[1], acc[2], gyr[0], gyr[1], gyr[2], mag[0], mag[1], mag[2], rhall);
+        samples++;
+    }
+    double elapsed = wall_seconds() - t0;
+
+    fprintf(stderr, "samples: %lu\n", samples);
+    fprintf(stderr, "mag mode: %d\n", (int)IMU_getMagMode());
+    fprintf(stderr, "mismatches: %lu\n", (unsigned long)IMU_replayMismatches());
+    fprintf(stderr, "replay time: %.3f s (%.0f samples/s)\n", elapsed,
+            elapsed > 0 ? samples / elapsed : 0.0);
+    return IMU_replayMismatches() == 0 ? 0 : 1;
+}
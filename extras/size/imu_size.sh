@@ -0,0 +1,102 @@
+#!/bin/sh
+# @file imu_size.sh
+# @brief Вклад возможностей драйвера (IMU_Features.h) во flash и ОЗУ
+#
+# Собирает extras/size/size_sketch со всеми возможностями, с каждой
+# выключенной по отдельности и с IMU_PROFILE_MINIMAL, и по выводу size
+# для ELF печатает таблицу: flash = text + data, ОЗУ = data + bss
+# (статические данные, без стека и кучи), колонки d_flash/d_ram — вклад
+# возможности (насколько сборка без нее меньше полной).
+#
+# Сборка для платы — arduino-cli с пакетом arduino:avr и avr-size:
+#   extras/size/imu_size.sh                              # arduino:avr:uno
+#   extras/size/imu_size.sh --fqbn arduino:avr:nano
+# Без встроенного инструментария — оценка на хосте (g++ -Os с gc-sections
+# и extras/host, числа x86-64 годятся только для сравнения между строками;
+# Serial на хосте подключен всегда, поэтому вклад SERIAL_BEGIN не виден):
+#   extras/size/imu_size.sh --host
+#
+# Проверка бюджета: сборка с флагами --profile не должна превышать
+# заданные flash и ОЗУ (байт), иначе код возврата 1:
+#   extras/size/imu_size.sh --profile "-DIMU_PROFILE_MINIMAL" --budget 8192 400
+#
+# @author AXIOMICA
+# @date 2026-10-18
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+SKETCH="$ROOT/extras/size/size_sketch"
+FQBN=arduino:avr:uno
+HOST=0
+PROFILE=""
+BUDGET_FLASH=""
+BUDGET_RAM=""
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --fqbn) FQBN="$2"; shift 2 ;;
+        --host) HOST=1; shift ;;
+        --profile) PROFILE="$2"; shift 2 ;;
+        --budget) BUDGET_FLASH="$2"; BUDGET_RAM="$3"; shift 3 ;;
+        *) echo "usage: $0 [--fqbn FQBN | --host] [--profile FLAGS --budget FLASH RAM]" >&2; exit 2 ;;
+    esac
+done
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Собирает скетч с флагами $2, ELF — в $TMP/$1.elf
+build() {
+    name=$1
+    flags=$2
+    if [ "$HOST" = 1 ]; then
+        printf '#include "%s/size_sketch.ino"\nint main() { setup(); loop(); return 0; }\n' "$SKETCH" > "$TMP/main.cpp"
+        # shellcheck disable=SC2086
+        g++ -Os -std=gnu++11 -ffunction-sections -fdata-sections -Wl,--gc-sections $flags \
+            -I "$ROOT/extras/host" -I "$ROOT" "$ROOT"/*.cpp "$ROOT/extras/host/host_arduino.cpp" \
+            "$TMP/main.cpp" -o "$TMP/$name.elf"
+    else
+        arduino-cli compile --fqbn "$FQBN" --library "$ROOT" \
+            --build-property "compiler.cpp.extra_flags=$flags" \
+            --build-path "$TMP/build_$name" "$SKETCH" > "$TMP/$name.log" 2>&1 ||
+            { cat "$TMP/$name.log" >&2; exit 1; }
+        cp "$TMP/build_$name/size_sketch.ino.elf" "$TMP/$name.elf"
+    fi
+}
+
+# Печатает "flash ram" для ELF $1 (формат Berkeley: text data bss)
+measure() {
+    if [ "$HOST" = 1 ]; then SIZE=size; else SIZE=avr-size; fi
+    $SIZE "$1" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+}
+
+if [ -n "$BUDGET_FLASH" ]; then
+    build profile "$PROFILE"
+    set -- $(measure "$TMP/profile.elf")
+    echo "profile '$PROFILE': flash $1 / $BUDGET_FLASH, ram $2 / $BUDGET_RAM"
+    [ "$1" -le "$BUDGET_FLASH" ] && [ "$2" -le "$BUDGET_RAM" ] && exit 0
+    echo "budget exceeded" >&2
+    exit 1
+fi
+
+build full ""
+set -- $(measure "$TMP/full.elf")
+FULL_FLASH=$1
+FULL_RAM=$2
+
+printf '%-26s %8s %8s %8s %8s\n' configuration flash ram d_flash d_ram
+printf '%-26s %8d %8d %8s %8s\n' "all features" "$FULL_FLASH" "$FULL_RAM" - -
+
+for cfg in \
+    "IMU_FEATURE_SECONDARY=0" \
+    "IMU_FEATURE_FULL_SCAN=0" \
+    "IMU_FEATURE_AUTORANGE=0" \
+    "IMU_FEATURE_SHADOW=0" \
+    "IMU_FEATURE_SERIAL_BEGIN=0" \
+    "IMU_PROFILE_MINIMAL"; do
+    name=$(echo "$cfg" | tr '=' '_')
+    build "$name" "-D$cfg"
+    set -- $(measure "$TMP/$name.elf")
+    printf '%-26s %8d %8d %8d %8d\n' "$cfg" "$1" "$2" $((FULL_FLASH - $1)) $((FULL_RAM - $2))
+done
@@ -0,0 +1,22 @@
+/**
+ * @file size_sketch.ino
+ * @brief Минимальный скетч для измерения размера драйвера (extras/size/imu_size.sh)
+ * 
+ * Вызывает только IMU_begin() и IMU_readData() и не использует Serial,
+ * поэтому разница размеров между сборками — это вклад возможностей драйвера.
+ * 
+ * @author AXIOMICA
+ * @date 2026-10-18
+ */
+
+#include <IMU_BMI160_BMM150.h>
+
+int16_t acc[3], gyr[3], mag[3], rhall;
+
+void setup() {
+    IMU_begin();
+}
+
+void loop() {
+    IMU_readData(acc, gyr, mag, &rhall);
+}